@@ -1,10 +1,9 @@
 #include <autoplay.hpp>
 
-#include <pthread.h>
-
 AutoPlay::AutoPlay()
 {
-    engine = core->engine;
+    // DECORATION ONLY, ONE SEARCH THREAD LEAVES THE MACHINE IDLE WHILE THE MENU IS OPEN
+    engine = core->engine_pool->Acquire(8, 1);
     board = core->board;
     Reset();
 }
@@ -12,29 +11,23 @@ AutoPlay::AutoPlay()
 void AutoPlay::Reset()
 {
     board->Reset();
-    core->engine->SetLevel(8);
-    core->engine->RunVoidCommand("ucinewgame");
-    core->engine->SetPosition(core->board->GetFENString());
+    engine->Cancel();
+    engine->NewGame(8);
 
-    engine_thread_done = false;
-    engine_thread_started = false;
+    engine_move_future = std::future<std::string>();
+    engine_move_ready = false;
     engine_time = 0;
 }
 
-static void* EngineMakeMove(void *obj)
-{
-    AutoPlay *autoplay = (AutoPlay*)obj;
-
-    core->engine->SetPosition(core->board->GetFENString());
-    autoplay->engine_move = core->engine->GetBestMove();
-    autoplay->engine_thread_done = true;
-
-    return nullptr;
-}
-
 void AutoPlay::Process()
 {
-    if(engine_thread_done)
+    if(IsReady(engine_move_future))
+    {
+        engine_move = engine_move_future.get();
+        engine_move_ready = true;
+    }
+
+    if(engine_move_ready)
     {
         if(engine_time < 1.f)
         {
@@ -42,23 +35,24 @@ void AutoPlay::Process()
         }
         else
         {
-            engine_thread_started = false;
-            engine_thread_done = false;
+            engine_move_ready = false;
             engine_time = 0;
-            board->MakeMove(engine_move);
-            if(board->IsGameFinished())
+            // AN EMPTY MOVE MEANS THE REQUEST WAS CANCELLED, THE NEXT FRAME ASKS AGAIN
+            if(!engine_move.empty())
             {
-                board->Reset();
+                board->MakeMove(engine_move);
+                if(board->IsGameFinished())
+                {
+                    board->Reset();
+                }
             }
         }
     }
     else
     {
-        if(!engine_thread_started)
+        if(!engine_move_future.valid())
         {
-            engine_thread_started = true;
-            pthread_t move_thread;
-            pthread_create(&move_thread, nullptr, EngineMakeMove, (void*)this);
+            engine_move_future = engine->GetBestMove(*board, SwitchState());
         }
         engine_time += core->delta_time;
     }
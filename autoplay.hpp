@@ -6,18 +6,18 @@
 #include <assets.hpp>
 #include <utils.hpp>
 #include <chess.hpp>
-#include <uci_engine.hpp>
+#include <engine.hpp>
 
 #include <raylib/raylib.h>
 #include <raylib/raymath.h>
 
 struct AutoPlay
 {
-    UCIEngine *engine;
+    EngineWorker *engine;
     Board *board;
 
-    bool engine_thread_done;
-    bool engine_thread_started;
+    std::future<std::string> engine_move_future;
+    bool engine_move_ready;
     std::string engine_move;
     float engine_time;
 
@@ -1,2 +1,2 @@
-g++ -w -o switch_chess.exe switch_chess.cpp chess.cpp uci_engine.cpp core.cpp assets.cpp utils.cpp anim_text.cpp scene_game.cpp -IC:/Users/padmadevd/programming/cyg_libs/include -I. -LC:/Users/padmadevd/programming/cyg_libs/libs -lraylib -luser32 -lgdi32 -lshell32
+g++ -w -o switch_chess.exe switch_chess.cpp chess.cpp engine.cpp transposition_table.cpp engine_worker.cpp engine_pool.cpp switch_chess_game.cpp pgn.cpp core.cpp assets.cpp utils.cpp anim_text.cpp scene_game.cpp -IC:/Users/padmadevd/programming/cyg_libs/include -I. -LC:/Users/padmadevd/programming/cyg_libs/libs -lraylib -luser32 -lgdi32 -lshell32
 ./switch_chess.exe
\ No newline at end of file
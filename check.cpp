@@ -0,0 +1,243 @@
+#include <engine_worker.hpp>
+#include <match.hpp>
+#include <pgn.hpp>
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <thread>
+
+// USAGE
+//   check
+//
+// RUNS THE HEADLESS CHECKS BELOW AND EXITS NON-ZERO IF ANY FAILS. perft --suite COVERS MOVE GENERATION,
+// THESE COVER WHAT SITS ON TOP OF IT.
+
+#define CANCEL_DEADLINE_MS 100	// A CANCELLED REQUEST MUST ANSWER WITHIN THIS, ITS SEARCHES ARE GIVEN 2000 ms
+
+template<typename T>
+static bool ResolvesBy(std::future<T> &future, uint32_t ms)
+{
+	return future.wait_for(std::chrono::milliseconds(ms)) == std::future_status::ready;
+}
+
+// A JOB ALREADY TAKEN OFF THE QUEUE BUT NOT SEARCHING YET WHEN THE CANCEL COMES MUST NOT SEARCH ITS FULL TIME
+static bool CheckCancelBeforeSearch()
+{
+	Engine engine;
+	engine.SetMoveTime(2000);
+	EngineWorker worker(&engine);
+
+	std::promise<void> taken, go;
+	std::shared_future<void> go_signal = go.get_future().share();
+	std::shared_ptr<std::promise<uint32_t>> searched = std::make_shared<std::promise<uint32_t>>();
+	std::future<uint32_t> future = searched->get_future();
+
+	worker.Push([&taken, go_signal, searched](Engine *engine, bool cancelled)
+	{
+		taken.set_value();
+		go_signal.wait();
+		searched->set_value(cancelled ? 0 : engine->Search(engine->GetLevelLimits())._time);
+	});
+	taken.get_future().wait();
+	worker.Cancel();
+	go.set_value();
+
+	if(!ResolvesBy(future, CANCEL_DEADLINE_MS))
+	{
+		printf("  search started after the cancel still running\n");
+		future.wait();
+		return false;
+	}
+	return true;
+}
+
+// CANCEL RIGHT AFTER SUBMITTING, AT EVERY POINT AROUND THE WORKER TAKING THE JOB OFF THE QUEUE
+static bool CheckCancelBestMove()
+{
+	Engine engine;
+	engine.SetMoveTime(2000);
+	EngineWorker worker(&engine);
+	Board board;
+
+	for(uint32_t i = 0; i < 200; i++)
+	{
+		std::future<std::string> future = worker.GetBestMove(board, SwitchState());
+		std::this_thread::sleep_for(std::chrono::microseconds(i%20 * 10));
+		worker.Cancel();
+		if(!ResolvesBy(future, CANCEL_DEADLINE_MS))
+		{
+			printf("  GetBestMove cancelled after %u us still searching\n", i%20 * 10);
+			return false;
+		}
+	}
+	return true;
+}
+
+// DecidePass RUNS SEVERAL SEARCHES, A CANCEL DURING THE FIRST MUST STOP THE REST TOO
+static bool CheckCancelDecidePass()
+{
+	Engine engine;
+	engine.SetMoveTime(2000);
+	EngineWorker worker(&engine);
+	Board board;
+
+	SwitchState state;
+	state._enabled = true;
+	state._engine_color = COLOR_W;
+	state._white_has_pass = true;
+	state._black_has_pass = true;
+
+	for(uint32_t ms = 0; ms < 20; ms += 5)
+	{
+		std::future<PassDecision> future = worker.DecidePass(board, state);
+		std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+		worker.Cancel();
+		if(!ResolvesBy(future, CANCEL_DEADLINE_MS))
+		{
+			printf("  DecidePass cancelled after %u ms still searching\n", ms);
+			return false;
+		}
+	}
+	return true;
+}
+
+// PROMOTION LETTERS IN EITHER CASE, WITH AND WITHOUT '=', INCLUDING THE BISHOP "b" THAT LOOKS LIKE A FILE
+static bool CheckPgnPromotions()
+{
+	const char *text =
+		"[FEN \"8/1P4P1/8/7k/3K4/8/1p4p1/8 w - - 0 1\"]\n"
+		"\n"
+		"1. b8=b b1B 2. g8n g1=r 3. Bc7 Rg7 *\n";
+	const char *expected[] = {"b7b8b", "b2b1b", "g7g8n", "g2g1r", "b8c7", "g1g7"};
+	uint32_t count = sizeof(expected)/sizeof(expected[0]);
+
+	FILE *file = tmpfile();
+	if(file == nullptr) return false;
+	fputs(text, file);
+	rewind(file);
+
+	PgnReader reader(file);
+	PgnGame game;
+	bool ok = reader.Next(game) && game._valid && game._events.size() == count;
+	for(uint32_t i = 0; ok && i < count; i++)
+	{
+		if(GetMoveString(game._events[i]._move) != expected[i])
+		{
+			printf("  move %u read as %s, expected %s\n", i+1, GetMoveString(game._events[i]._move).c_str(), expected[i]);
+			ok = false;
+		}
+	}
+	if(ok && reader.Next(game)) ok = false;
+	fclose(file);
+
+	if(!ok && game._events.size() != count) printf("  read %u of %u moves\n", (uint32_t)game._events.size(), count);
+	return ok;
+}
+
+// WHAT FOLLOWS A RESULT, OR COMES BEFORE THE FIRST GAME, IS NOT A GAME OF ITS OWN
+static bool CheckPgnTrailing()
+{
+	const char *text =
+		"{collection header}\n"
+		"[Event \"one\"]\n"
+		"\n"
+		"1. e4 e5 1-0 {post} $1 stray\n"
+		"\n"
+		"[Event \"two\"]\n"
+		"\n"
+		"1. d4 {[%card plus5]} d5 0-1\n"
+		"{trailing} ; and a line comment [x]\n";
+
+	FILE *file = tmpfile();
+	if(file == nullptr) return false;
+	fputs(text, file);
+	rewind(file);
+
+	PgnReader reader(file);
+	PgnGame game;
+	std::string names;
+	uint32_t games = 0;
+	while(reader.Next(game))
+	{
+		games++;
+		names += game.GetTag("Event") + " " + game._result + " " + std::to_string(game._events.size()) + ";";
+	}
+	fclose(file);
+
+	if(names != "one 1-0 2;two 0-1 3;")
+	{
+		printf("  read %u games: %s\n", games, names.c_str());
+		return false;
+	}
+	return true;
+}
+
+// THE switches COLUMN MUST COUNT EVERY SWITCH THE PGN RECORDS, THE ONES NO PASS DECISION PRECEDED INCLUDED
+static bool CheckMatchSwitches()
+{
+	MatchConfig config;
+	config._games = 8;
+	config._threads = 4;
+	config._level[SWITCH_PLAYER_1] = 1;
+	config._level[SWITCH_PLAYER_2] = 2;
+	config._move_time = 2;
+	config._seed = 3;
+
+	FILE *file = tmpfile();
+	if(file == nullptr) return false;
+
+	uint32_t csv_switches = 0;
+	PgnGame pgn;
+	RunMatch(config, [&](MatchGame &game)
+	{
+		csv_switches += game._switches;
+		GetMatchGamePgn(game, pgn);
+		WritePgn(file, pgn);
+		return true;
+	});
+
+	rewind(file);
+	uint32_t pgn_switches = 0;
+	char line[256];
+	while(fgets(line, sizeof(line), file))
+	{
+		for(char *at = line; (at = strstr(at, "[%switch]")) != nullptr; at++) pgn_switches++;
+	}
+	fclose(file);
+
+	if(csv_switches != pgn_switches || pgn_switches == 0)
+	{
+		printf("  csv counts %u switches, pgn records %u\n", csv_switches, pgn_switches);
+		return false;
+	}
+	return true;
+}
+
+struct Check
+{
+	const char *name;
+	bool (*run)();
+};
+
+static const Check Checks[] = {
+	{"cancel before search", CheckCancelBeforeSearch},
+	{"cancel best move", CheckCancelBestMove},
+	{"cancel pass decision", CheckCancelDecidePass},
+	{"pgn lowercase promotions", CheckPgnPromotions},
+	{"pgn text around games", CheckPgnTrailing},
+	{"match switch count", CheckMatchSwitches},
+};
+
+int main()
+{
+	int failed = 0;
+	for(const Check &check : Checks)
+	{
+		bool ok = check.run();
+		printf("%-32s %s\n", check.name, ok ? "ok" : "FAILED");
+		if(!ok) failed++;
+	}
+	printf("\n%d of %d checks failed\n", failed, (int)(sizeof(Checks)/sizeof(Checks[0])));
+	return failed ? 1 : 0;
+}
@@ -1,5 +1,6 @@
 #include <chess.hpp>
 
+#include <ctype.h>
 #include <stdio.h>
 #include <sstream>
 
@@ -166,8 +167,265 @@ uint8_t TypeOf(uint8_t piece)
 	return PIECE_NONE;
 }
 
+Bitboard KnightAttacks[64];
+Bitboard KingAttacks[64];
+Bitboard PawnAttacks[4][64];
+Bitboard Between[64][64];
+Bitboard Line[64][64];
+
+// RAY DIRECTIONS, THE FIRST FOUR WALK TOWARDS HIGHER SQUARE INDICES AND dir+4 IS THE OPPOSITE OF dir
+#define DIR_EAST 0
+#define DIR_SOUTH 1
+#define DIR_SOUTH_EAST 2
+#define DIR_SOUTH_WEST 3
+#define DIR_WEST 4
+#define DIR_NORTH 5
+#define DIR_NORTH_WEST 6
+#define DIR_NORTH_EAST 7
+
+static Bitboard Rays[8][64];
+
+static uint8_t Step(uint8_t square, uint8_t dir)
+{
+	switch(dir)
+	{
+		case DIR_EAST:
+			return East(square);
+		case DIR_SOUTH:
+			return South(square);
+		case DIR_SOUTH_EAST:
+			return East(South(square));
+		case DIR_SOUTH_WEST:
+			return West(South(square));
+		case DIR_WEST:
+			return West(square);
+		case DIR_NORTH:
+			return North(square);
+		case DIR_NORTH_EAST:
+			return East(North(square));
+		case DIR_NORTH_WEST:
+			return West(North(square));
+	}
+	return SQUARE_NONE;
+}
+
+static Bitboard RayAttacks(uint8_t square, Bitboard occupied, uint8_t dir)
+{
+	Bitboard attacks = Rays[dir][square];
+	Bitboard blockers = attacks & occupied;
+	if(blockers)
+	{
+		uint8_t blocker = (dir < DIR_WEST) ? LSB(blockers) : MSB(blockers);
+		attacks ^= Rays[dir][blocker];
+	}
+	return attacks;
+}
+
+static Bitboard SlidingAttacks(uint8_t type, uint8_t square, Bitboard occupied)
+{
+	if(type == ROOK)
+		return RayAttacks(square, occupied, DIR_EAST) | RayAttacks(square, occupied, DIR_WEST)
+			| RayAttacks(square, occupied, DIR_NORTH) | RayAttacks(square, occupied, DIR_SOUTH);
+	return RayAttacks(square, occupied, DIR_NORTH_EAST) | RayAttacks(square, occupied, DIR_NORTH_WEST)
+		| RayAttacks(square, occupied, DIR_SOUTH_EAST) | RayAttacks(square, occupied, DIR_SOUTH_WEST);
+}
+
+// SLIDING ATTACK TABLES
+Magic RookMagics[64];
+Magic BishopMagics[64];
+bool UsePext = false;
+
+static Bitboard RookTable[0x19000];
+static Bitboard BishopTable[0x1480];
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+
+__attribute__((target("bmi2"))) uint32_t PextIndex(Bitboard occupied, Bitboard mask)
+{
+	return _pext_u64(occupied, mask);
+}
+#else
+uint32_t PextIndex(Bitboard occupied, Bitboard mask)
+{
+	return 0;
+}
+#endif
+
+static bool CpuHasPext()
+{
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("bmi2");
+#else
+	return false;
+#endif
+}
+
+// MAGIC MULTIPLIERS FOR THIS BOARD'S SQUARE LAYOUT (A8 = 0), FOUND OFFLINE BY RANDOM SEARCH
+static const Bitboard RookMagicNumbers[64] = {
+	0x0A80004000801220ULL, 0x8040004010002008ULL, 0x2080200010008008ULL, 0x1100100008210004ULL,
+	0xC200209084020008ULL, 0x2100010004000208ULL, 0x0400081000822421ULL, 0x0200010422048844ULL,
+	0x0800800080400024ULL, 0x0001402000401000ULL, 0x3000801000802001ULL, 0x4400800800100083ULL,
+	0x0904802402480080ULL, 0x4040800400020080ULL, 0x0018808042000100ULL, 0x4040800080004100ULL,
+	0x0040048001458024ULL, 0x00A0004000205000ULL, 0x3100808010002000ULL, 0x4825010010000820ULL,
+	0x5004808008000401ULL, 0x2024818004000A00ULL, 0x0005808002000100ULL, 0x2100060004806104ULL,
+	0x0080400880008421ULL, 0x4062220600410280ULL, 0x010A004A00108022ULL, 0x0000100080080080ULL,
+	0x0021000500080010ULL, 0x0044000202001008ULL, 0x0000100400080102ULL, 0xC020128200040545ULL,
+	0x0080002000400040ULL, 0x0000804000802004ULL, 0x0000120022004080ULL, 0x010A386103001001ULL,
+	0x9010080080800400ULL, 0x8440020080800400ULL, 0x0004228824001001ULL, 0x000000490A000084ULL,
+	0x0080002000504000ULL, 0x200020005000C000ULL, 0x0012088020420010ULL, 0x0010010080080800ULL,
+	0x0085001008010004ULL, 0x0002000204008080ULL, 0x0040413002040008ULL, 0x0000304081020004ULL,
+	0x0080204000800080ULL, 0x3008804000290100ULL, 0x1010100080200080ULL, 0x2008100208028080ULL,
+	0x5000850800910100ULL, 0x8402019004680200ULL, 0x0120911028020400ULL, 0x0000008044010200ULL,
+	0x0020850200244012ULL, 0x0020850200244012ULL, 0x0000102001040841ULL, 0x140900040A100021ULL,
+	0x000200282410A102ULL, 0x000200282410A102ULL, 0x000200282410A102ULL, 0x4048240043802106ULL
+};
+static const Bitboard BishopMagicNumbers[64] = {
+	0x9060124418008010ULL, 0x0020010250810120ULL, 0x2010010220280081ULL, 0x002806004050C040ULL,
+	0x0002021018000000ULL, 0x2001112010000400ULL, 0x0881010120218080ULL, 0x1030820110010500ULL,
+	0x0000120222042400ULL, 0x2000020404040044ULL, 0x8000480094208000ULL, 0x0003422A02000001ULL,
+	0x000A220210100040ULL, 0x8004820202226000ULL, 0x0018234854100800ULL, 0x0100004042101040ULL,
+	0x0004001004082820ULL, 0x0010000810010048ULL, 0x1014004208081300ULL, 0x2080818802044202ULL,
+	0x0040880C00A00100ULL, 0x0080400200522010ULL, 0x0001000188180B04ULL, 0x0080249202020204ULL,
+	0x1004400004100410ULL, 0x00013100A0022206ULL, 0x2148500001040080ULL, 0x4241080011004300ULL,
+	0x4020848004002000ULL, 0x10101380D1004100ULL, 0x0008004422020284ULL, 0x01010A1041008080ULL,
+	0x0808080400082121ULL, 0x0808080400082121ULL, 0x0091128200100C00ULL, 0x0202200802010104ULL,
+	0x8C0A020200440085ULL, 0x01A0008080B10040ULL, 0x0889520080122800ULL, 0x100902022202010AULL,
+	0x04081A0816002000ULL, 0x0000681208005000ULL, 0x8170840041008802ULL, 0x0A00004200810805ULL,
+	0x0830404408210100ULL, 0x2602208106006102ULL, 0x1048300680802628ULL, 0x2602208106006102ULL,
+	0x0602010120110040ULL, 0x0941010801043000ULL, 0x000040440A210428ULL, 0x0008240020880021ULL,
+	0x0400002012048200ULL, 0x00AC102001210220ULL, 0x0220021002009900ULL, 0x84440C080A013080ULL,
+	0x0001008044200440ULL, 0x0004C04410841000ULL, 0x2000500104011130ULL, 0x1A0C010011C20229ULL,
+	0x0044800112202200ULL, 0x0434804908100424ULL, 0x0300404822C08200ULL, 0x48081010008A2A80ULL
+};
+
+static void InitMagics(uint8_t type)
+{
+	Magic *magics = (type == ROOK) ? RookMagics : BishopMagics;
+	Bitboard *table = (type == ROOK) ? RookTable : BishopTable;
+
+	for(uint8_t s = 0; s < 64; ++s)
+	{
+		// BOARD EDGES NEVER BLOCK A RAY, SO THEY ARE LEFT OUT OF THE MASK
+		Bitboard edges = ((RANK_8_BB | RANK_1_BB) & ~(RANK_8_BB << (s/8*8)))
+			| ((FILE_A_BB | FILE_H_BB) & ~(FILE_A_BB << (s%8)));
+
+		Magic &m = magics[s];
+		m._mask = SlidingAttacks(type, s, 0) & ~edges;
+		m._magic = (type == ROOK) ? RookMagicNumbers[s] : BishopMagicNumbers[s];
+		m._shift = 64 - PopCount(m._mask);
+		m._attacks = (s == 0) ? table : magics[s-1]._attacks + (1 << (64 - magics[s-1]._shift));
+
+		// CARRY-RIPPLER ENUMERATION OF EVERY BLOCKER SUBSET OF THE MASK
+		Bitboard b = 0;
+		do
+		{
+			m._attacks[m.Index(b)] = SlidingAttacks(type, s, b);
+			b = (b - m._mask) & m._mask;
+		} while(b);
+	}
+}
+
+void InitBitboards()
+{
+	UsePext = CpuHasPext();
+
+	int xL[] = {2, 2, -2, -2, 1, 1, -1, -1};
+	int yL[] = {1, -1, 1, -1, 2, -2, 2, -2};
+
+	for(uint8_t s = 0; s < 64; ++s)
+	{
+		KnightAttacks[s] = 0;
+		for(uint8_t i = 0; i < 8; ++i)
+		{
+			int x = s%8 + xL[i];
+			int y = s/8 + yL[i];
+			if(x >= 0 && x < 8 && y >= 0 && y < 8) KnightAttacks[s] |= SquareBB(y*8+x);
+		}
+
+		KingAttacks[s] = 0;
+		for(uint8_t dir = 0; dir < 8; ++dir)
+		{
+			Rays[dir][s] = 0;
+			uint8_t t = Step(s, dir);
+			if(IsValidSquare(t)) KingAttacks[s] |= SquareBB(t);
+			while(IsValidSquare(t))
+			{
+				Rays[dir][s] |= SquareBB(t);
+				t = Step(t, dir);
+			}
+		}
+
+		PawnAttacks[COLOR_NONE][s] = 0;
+		PawnAttacks[COLOR_ALL][s] = 0;
+		PawnAttacks[COLOR_W][s] = 0;
+		PawnAttacks[COLOR_B][s] = 0;
+		if(IsValidSquare(Step(s, DIR_NORTH_EAST))) PawnAttacks[COLOR_W][s] |= SquareBB(Step(s, DIR_NORTH_EAST));
+		if(IsValidSquare(Step(s, DIR_NORTH_WEST))) PawnAttacks[COLOR_W][s] |= SquareBB(Step(s, DIR_NORTH_WEST));
+		if(IsValidSquare(Step(s, DIR_SOUTH_EAST))) PawnAttacks[COLOR_B][s] |= SquareBB(Step(s, DIR_SOUTH_EAST));
+		if(IsValidSquare(Step(s, DIR_SOUTH_WEST))) PawnAttacks[COLOR_B][s] |= SquareBB(Step(s, DIR_SOUTH_WEST));
+	}
+
+	for(uint8_t s = 0; s < 64; ++s)
+	{
+		for(uint8_t t = 0; t < 64; ++t)
+		{
+			Between[s][t] = 0;
+			Line[s][t] = 0;
+		}
+		for(uint8_t dir = 0; dir < 8; ++dir)
+		{
+			Bitboard ray = Rays[dir][s];
+			while(ray)
+			{
+				uint8_t t = PopLSB(ray);
+				Between[s][t] = Rays[dir][s] & ~Rays[dir][t] & ~SquareBB(t);
+				Line[s][t] = Rays[dir][s] | Rays[(dir+4)%8][s] | SquareBB(s);
+			}
+		}
+	}
+
+	InitMagics(ROOK);
+	InitMagics(BISHOP);
+}
+
+// ZOBRIST KEYS, GENERATED FROM A FIXED SEED SO KEYS MATCH ACROSS PROCESSES AND HOSTS
+uint64_t ZobristPieces[13][64];
+uint64_t ZobristCastle[4];
+uint64_t ZobristEnPassant[8];
+uint64_t ZobristSide;
+
+void InitZobrist()
+{
+	uint64_t seed = 0x5DEECE66DULL;
+	auto random = [&seed]()
+	{
+		seed ^= seed >> 12;
+		seed ^= seed << 25;
+		seed ^= seed >> 27;
+		return seed * 2685821657736338717ULL;
+	};
+
+	for(uint8_t s = 0; s < 64; ++s)
+	{
+		ZobristPieces[EMPTY][s] = 0;
+		for(uint8_t p = RB; p <= PW; ++p) ZobristPieces[p][s] = random();
+	}
+	for(uint8_t i = 0; i < 4; ++i) ZobristCastle[i] = random();
+	for(uint8_t i = 0; i < 8; ++i) ZobristEnPassant[i] = random();
+	ZobristSide = random();
+}
+
+// MATERIAL VALUE OF EACH PIECE IN CENTIPAWNS, THE KINGS COUNT AS NOTHING
+const int32_t PieceValue[13] = {0, 500, 320, 330, 900, 0, 100, 500, 320, 330, 900, 0, 100};
+
 Board::Board()
 {
+	static bool tables_ready = (InitBitboards(), InitZobrist(), true);
+	(void)tables_ready;
+
+	_make_move_legality = false;
 	Reset();
 }
 
@@ -190,22 +448,22 @@ void Board::Reset()
 		if(_squares[i] == KW) _kw_square = i;
 		if(_squares[i] == KB) _kb_square = i;
 	}
-
-	_uncastle_move_w = -1;
-	_uncastle_move_w_q = -1;
-	_uncastle_move_b = -1;
-	_uncastle_move_b_q = -1;
+	ComputeBitboards();
 
 	_can_castle_w = true;
 	_can_castle_w_q = true;
 	_can_castle_b = true;
 	_can_castle_b_q = true;
+	_ep_square = SQUARE_NONE;
 
 	_move_history.clear();
 	_move_count = 0;
 	_half_move_clock = 0;
 	_full_move_clock = 1;
 	_current_color = COLOR_W;
+
+	ComputeHash();
+	_status_valid = false;
 }
 
 uint8_t Board::At(uint8_t square)
@@ -226,9 +484,75 @@ void Board::Set(uint8_t square, uint8_t piece)
 
 	if(piece == KB) _kb_square = square;
 	if(piece == KW) _kw_square = square;
+
+	Bitboard bb = SquareBB(square);
+	uint8_t old = _squares[square];
+	_hash ^= ZobristPieces[old][square] ^ ZobristPieces[piece][square];
+	_piece_bb[old] ^= bb;
+	_piece_bb[piece] ^= bb;
+	if(old != EMPTY) _color_bb[ColorOf(old)] ^= bb;
+	if(piece != EMPTY) _color_bb[ColorOf(piece)] ^= bb;
+	_color_bb[COLOR_ALL] = _color_bb[COLOR_W] | _color_bb[COLOR_B];
+
+	_piece_count[old]--;
+	_piece_count[piece]++;
+	_material[ColorOf(old)] -= PieceValue[old];
+	_material[ColorOf(piece)] += PieceValue[piece];
 	_squares[square] = piece;
 }
 
+uint64_t Board::StateKey()
+{
+	uint64_t key = 0;
+	if(_current_color == COLOR_B) key ^= ZobristSide;
+	if(_can_castle_w) key ^= ZobristCastle[0];
+	if(_can_castle_w_q) key ^= ZobristCastle[1];
+	if(_can_castle_b) key ^= ZobristCastle[2];
+	if(_can_castle_b_q) key ^= ZobristCastle[3];
+
+	// THE EN PASSANT FILE ONLY COUNTS WHEN A PAWN OF THE SIDE TO MOVE COULD TAKE
+	if(_ep_square != SQUARE_NONE)
+	{
+		uint8_t pawn = (_current_color == COLOR_W) ? PW : PB;
+		uint8_t enemy = (_current_color == COLOR_W) ? COLOR_B : COLOR_W;
+		if(PawnAttacks[enemy][_ep_square] & _piece_bb[pawn]) key ^= ZobristEnPassant[_ep_square%8];
+	}
+	return key;
+}
+
+void Board::ComputeHash()
+{
+	_hash = StateKey();
+	for(uint8_t i = 0; i < 64; ++i)
+	{
+		_hash ^= ZobristPieces[_squares[i]][i];
+	}
+	_hash_history.clear();
+}
+
+void Board::ComputeBitboards()
+{
+	for(uint8_t p = EMPTY; p <= PW; ++p) _piece_bb[p] = 0;
+	for(uint8_t c = COLOR_NONE; c <= COLOR_ALL; ++c)
+	{
+		_color_bb[c] = 0;
+		_material[c] = 0;
+	}
+
+	for(uint8_t i = 0; i < 64; ++i)
+	{
+		_piece_bb[_squares[i]] |= SquareBB(i);
+		if(_squares[i] != EMPTY) _color_bb[ColorOf(_squares[i])] |= SquareBB(i);
+	}
+
+	for(uint8_t p = EMPTY; p <= PW; ++p)
+	{
+		_piece_count[p] = PopCount(_piece_bb[p]);
+		_material[ColorOf(p)] += PieceValue[p]*_piece_count[p];
+	}
+	_color_bb[COLOR_ALL] = _color_bb[COLOR_W] | _color_bb[COLOR_B];
+}
+
 uint8_t Board::GetKing(uint8_t color)
 {
 	if(color != COLOR_B && color != COLOR_W) return SQUARE_NONE;
@@ -238,890 +562,528 @@ uint8_t Board::GetKing(uint8_t color)
 	return SQUARE_NONE;
 }
 
+Bitboard Board::AttackersTo(uint8_t square, Bitboard occupied)
+{
+	Bitboard rooks = _piece_bb[RW] | _piece_bb[RB] | _piece_bb[QW] | _piece_bb[QB];
+	Bitboard bishops = _piece_bb[BW] | _piece_bb[BB] | _piece_bb[QW] | _piece_bb[QB];
+
+	return (KnightAttacks[square] & (_piece_bb[NW] | _piece_bb[NB]))
+		| (KingAttacks[square] & (_piece_bb[KW] | _piece_bb[KB]))
+		| (PawnAttacks[COLOR_B][square] & _piece_bb[PW])
+		| (PawnAttacks[COLOR_W][square] & _piece_bb[PB])
+		| (RookAttacks(square, occupied) & rooks)
+		| (BishopAttacks(square, occupied) & bishops);
+}
+
 bool Board::IsInAttack(uint8_t square, uint8_t color)
 {
 	if(!IsValidSquare(square)) return false;
-	
+
 	uint8_t piece = At(square);
 	if(!IsValid(piece)) return false;
 
 	if(piece != EMPTY) color = ColorOf(piece);
-	uint8_t d, s;
+	Bitboard enemies = _color_bb[COLOR_ALL] & ~_color_bb[color];
 
-	// EAST
-	s = East(square);
-	d = 1;
-	while(IsValidSquare(s))
-	{
-		if(!IsEmpty(At(s)))
-		{
-			if(ColorOf(At(s)) == color) break;
-			else
-			{
-				uint8_t type = TypeOf(At(s));
-				if(type == ROOK || type == QUEEN || (type == KING && d == 1)) return true;
-				else break;
-			}
-		}
-		s = East(s);
-		d += 1;
-	}
+	return (AttackersTo(square, _color_bb[COLOR_ALL]) & enemies) != 0;
+}
 
-	// WEST
-	s = West(square);
-	d = 1;
-	while(IsValidSquare(s))
-	{
-		if(!IsEmpty(At(s)))
-		{
-			if(ColorOf(At(s)) == color) break;
-			else{
-				uint8_t type = TypeOf(At(s));
-				if(type == ROOK || type == QUEEN || (type == KING && d == 1)) return true;
-				else break;
-			}
-		}
-		s = West(s);
-		d += 1;
-	}
-	
-	// SOUTH
-	s = South(square);
-	d = 1;
-	while(IsValidSquare(s))
-	{
-		if(!IsEmpty(At(s)))
-		{
-			if(ColorOf(At(s)) == color) break;
-			else
-			{
-				uint8_t type = TypeOf(At(s));
-				if(type == ROOK || type == QUEEN || (type == KING && d == 1)) return true;
-				else break;
-			}
-		}
-		s = South(s);
-		d += 1;
-	}
+bool Board::IsInCheck(uint8_t color)
+{
+	return IsInAttack(GetKing(color), color);
+}
 
-	// NORTH
-	s = North(square);
-	d = 1;
-	while(IsValidSquare(s))
-	{
-		if(!IsEmpty(At(s)))
-		{
-			if(ColorOf(At(s)) == color) break;
-			else
-			{
-				uint8_t type = TypeOf(At(s));
-				if(type == ROOK || type == QUEEN || (type == KING && d == 1)) return true;
-				else break;
-			}
-		}
-		s = North(s);
-		d += 1;
-	}
+#include <iostream>
 
-	// NORTH - EAST
-	s = East(North(square));
-	d = 1;
-	while(IsValidSquare(s))
-	{
-		if(!IsEmpty(At(s)))
-		{
-			if(ColorOf(At(s)) == color) break;
-			else
-			{
-				uint8_t type = TypeOf(At(s));
-				if(type == BISHOP || type == QUEEN || (type == KING && d == 1) || (IsBlack(At(s)) && type == PAWN && d == 1)) return true;
-				else break;
-			}
-		}
-		s = East(North(s));
-		d += 1;
-	}
+uint8_t Board::GetCastleRights()
+{
+	return _can_castle_w | (_can_castle_w_q << 1) | (_can_castle_b << 2) | (_can_castle_b_q << 3);
+}
 
-	// NORTH - WEST
-	s = West(North(square));
-	d = 1;
-	while(IsValidSquare(s))
-	{
-		if(!IsEmpty(At(s)))
-		{
-			if(ColorOf(At(s)) == color) break;
-			else
-			{
-				uint8_t type = TypeOf(At(s));
-				if(type == BISHOP || type == QUEEN || (type == KING && d == 1) || (IsBlack(At(s)) && type == PAWN && d == 1)) return true;
-				else break;
-			}
-		}
-		s = West(North(s));
-		d += 1;
-	}
+void Board::SetCastleRights(uint8_t rights)
+{
+	_can_castle_w = rights & 1;
+	_can_castle_w_q = rights & 2;
+	_can_castle_b = rights & 4;
+	_can_castle_b_q = rights & 8;
+}
 
-	//SOUTH - EAST
-	s = East(South(square));
-	d = 1;
-	while(IsValidSquare(s))
+PackedMove PackMove(Move move)
+{
+	uint8_t flags = move._type;
+	if(move._type == PROMOTION)
 	{
-		if(!IsEmpty(At(s)))
+		switch(TypeOf(move._inserted))
 		{
-			if(ColorOf(At(s)) == color) break;
-			else
-			{
-				uint8_t type = TypeOf(At(s));
-				if(type == BISHOP || type == QUEEN || (type == KING && d == 1) || (IsWhite(At(s)) && type == PAWN && d == 1)) return true;
-				else break;
-			}
+			case ROOK:
+				flags = PROMOTION_R;
+				break;
+			case BISHOP:
+				flags = PROMOTION_B;
+				break;
+			case KNIGHT:
+				flags = PROMOTION_N;
+				break;
+			default:
+				flags = PROMOTION_Q;
+				break;
 		}
-		s = East(South(s));
-		d += 1;
 	}
+	return PackMove(move._start, move._end, flags);
+}
 
-	//SOUTH - WEST
-	s = West(South(square));
-	d = 1;
-	while(IsValidSquare(s))
-	{
-		if(!IsEmpty(At(s)))
-		{
-			if(ColorOf(At(s)) == color) break;
-			else
-			{
-				uint8_t type = TypeOf(At(s));
-				if(type == BISHOP || type == QUEEN || (type == KING && d == 1) || (IsWhite(At(s)) && type == PAWN && d == 1)) return true;
-				else break;
-			}
-		}
-		s = West(South(s));
-		d += 1;
-	}
+Move Board::UnpackMove(PackedMove packed)
+{
+	Move move;
+	move._start = MoveStart(packed);
+	move._end = MoveEnd(packed);
+	move._type = MoveType(packed);
 
-	int xL[] = {2, 2, -2, -2, 1, 1, -1, -1};
-	int yL[] = {1, -1, 1, -1, 2, -2, 2, -2};
-	for(uint8_t i = 0; i < 8; ++i)
+	uint8_t offset = IsWhite(At(move._start)) ? RW-RB : 0;
+	if(move._type == PROMOTION)
 	{
-		uint8_t x = square%8 + xL[i];
-		uint8_t y = square/8 + yL[i];
-		if((y >= 0 && y < 8) && (x >= 0 && x < 8) && TypeOf(At(x, y)) == KNIGHT && ColorOf(At(x, y)) != color) return true;
+		uint8_t pieces[] = {QB, RB, BB, NB};
+		move._inserted = pieces[MoveFlags(packed)-PROMOTION]+offset;
 	}
 
-	return false;
-}
-
-bool Board::IsInCheck(uint8_t color)
-{
-	return IsInAttack(GetKing(color), color);
+	if(move._type == CASTLING) move._deleted = EMPTY;
+	else if(move._type == ENPASSANT) move._deleted = At(IsWhite(At(move._start)) ? South(move._end) : North(move._end));
+	else move._deleted = At(move._end);
+	return move;
 }
 
-#include <iostream>
-
 void Board::MakeMove(Move move)
 {
 	if(!IsValidSquare(move._start) || !IsValidSquare(move._end) || move._start == move._end)
 		return;
 
+	MakeMove(PackMove(move));
+}
+
+void Board::MakeMove(PackedMove move)
+{
+	uint8_t start = MoveStart(move);
+	uint8_t end = MoveEnd(move);
+	uint8_t type = MoveType(move);
+	if(start == end) return;
+	_status_valid = false;
+
+	uint8_t piece = At(start);
+	uint8_t color = ColorOf(piece);
+	uint8_t captured_square = end;
+	if(type == ENPASSANT) captured_square = (color == COLOR_W) ? South(end) : North(end);
+
+	MoveUndo undo;
+	undo._move = move;
+	undo._captured = (type == CASTLING) ? EMPTY : At(captured_square);
+	undo._castle_rights = GetCastleRights();
+	undo._ep_square = _ep_square;
+	undo._half_move_clock = _half_move_clock;
+	_move_history.push_back(undo);
+
+	_hash_history.push_back(_hash);
+	_hash ^= StateKey();
+
 	_move_count += 1;
-	if(_can_castle_b && (At(move._start) == KB || move._start == H8 || move._end == H8))
-	{
-		_can_castle_b = false;
-		_uncastle_move_b = _move_count;
-	}
-	if(_can_castle_b_q && (At(move._start) == KB || move._start == A8 || move._end == A8))
-	{
-		_can_castle_b_q = false;
-		_uncastle_move_b_q = _move_count;
-	}
-	if(_can_castle_w && (At(move._start) == KW || move._start == H1 || move._end == H1))
-	{
-		_can_castle_w = false;
-		_uncastle_move_w = _move_count;
-	}
-	if(_can_castle_w_q && (At(move._start) == KW || move._start == A1 || move._end == A1))
-	{
-		_can_castle_w_q = false;
-		_uncastle_move_w_q = _move_count;
-	}
+	if(piece == KB || start == H8 || end == H8) _can_castle_b = false;
+	if(piece == KB || start == A8 || end == A8) _can_castle_b_q = false;
+	if(piece == KW || start == H1 || end == H1) _can_castle_w = false;
+	if(piece == KW || start == A1 || end == A1) _can_castle_w_q = false;
 
-	if(move._type == NORMAL || move._type == TWOSTEP)
+	if(type == ENPASSANT) Set(captured_square, EMPTY);
+	if(type == PROMOTION)
 	{
-		move._deleted = At(move._end);
-		if(At(move._start) == KB) _kb_square = move._end;
-		if(At(move._start) == KW) _kw_square = move._end;
-		Set(move._end, At(move._start));
-		Set(move._start, EMPTY);
+		uint8_t pieces[] = {QB, RB, BB, NB};
+		Set(end, pieces[MoveFlags(move)-PROMOTION]+(color == COLOR_W ? RW-RB : 0));
 	}
-	else if(move._type == CASTLING)
-	{
-		move._deleted = EMPTY;
-		if(At(move._start) == KB) _kb_square = move._end;
-		if(At(move._start) == KW) _kw_square = move._end;
-		Set(move._end, At(move._start));
-		Set(move._start, EMPTY);
-		if(move._end == G8 || move._end == G1)
-		{
-			Set(East(move._start), At(East(move._end)));
-			Set(East(move._end), EMPTY);
-		}
-		else
-		{
-			Set(West(move._start), At(West(West(move._end))));
-			Set(West(West(move._end)), EMPTY);
-		}
-	}
-	else if(move._type == ENPASSANT)
+	else Set(end, piece);
+	Set(start, EMPTY);
+
+	if(type == CASTLING)
 	{
-		if(IsWhite(At(move._start)))
+		if(end == G8 || end == G1)
 		{
-			Set(move._end, At(move._start));
-			Set(move._start, EMPTY);
-			move._deleted = At(South(move._end));
-			Set(South(move._end), EMPTY);
+			Set(West(end), At(East(end)));
+			Set(East(end), EMPTY);
 		}
 		else
 		{
-			Set(move._end, At(move._start));
-			Set(move._start, EMPTY);
-			move._deleted = At(North(move._end));
-			Set(North(move._end), EMPTY);
+			Set(East(end), At(West(West(end))));
+			Set(West(West(end)), EMPTY);
 		}
 	}
-	else if(move._type == PROMOTION)
-	{
-		move._deleted = At(move._end);
-		Set(move._end, move._inserted);
-		Set(move._start, EMPTY);
-	}
-	
-	_move_history.push_back(move);
 
-	if((move._deleted != INVALID && move._deleted != EMPTY) || TypeOf(At(move._end)) == PAWN)
-	{
-		_half_move_history.push_back(_half_move_clock);
-		_half_move_clock = -1;
-	}
+	_ep_square = (type == TWOSTEP) ? (start+end)/2 : SQUARE_NONE;
 
-	_half_move_clock++;
+	if(undo._captured != EMPTY || TypeOf(piece) == PAWN) _half_move_clock = 0;
+	else _half_move_clock++;
 	if(_current_color == COLOR_B) _full_move_clock++;
 
 	if(_current_color == COLOR_W) _current_color = COLOR_B;
 	else _current_color = COLOR_W;
+
+	_hash ^= StateKey();
 }
 
 void Board::UnMakeMove()
 {
 	if(_move_history.size() <= 0)
 		return;
-	
-	Move &move = _move_history.back();
-	if(!IsValidSquare(move._start) || !IsValidSquare(move._end)) return;
+	_status_valid = false;
 
-	if(!_can_castle_b && _move_count == _uncastle_move_b) _can_castle_b = true;
-	if(!_can_castle_w && _move_count == _uncastle_move_w) _can_castle_w = true;
-	if(!_can_castle_b_q && _move_count == _uncastle_move_b_q) _can_castle_b_q = true;
-	if(!_can_castle_w_q && _move_count == _uncastle_move_w_q) _can_castle_w_q = true;
+	MoveUndo undo = _move_history.back();
+	uint8_t start = MoveStart(undo._move);
+	uint8_t end = MoveEnd(undo._move);
+	uint8_t type = MoveType(undo._move);
 
-	if(move._type == NORMAL || move._type == TWOSTEP)
-	{
-		if(At(move._end) == KB) _kb_square = move._start;
-		if(At(move._end) == KW) _kw_square = move._start;
-		Set(move._start, At(move._end));
-		Set(move._end, move._deleted);
-	}
-	else if(move._type == CASTLING)
-	{
-		if(At(move._end) == KB) _kb_square = move._start;
-		if(At(move._end) == KW) _kw_square = move._start;
-		Set(move._start, At(move._end));
-		Set(move._end, EMPTY);
+	uint8_t piece = At(end);
+	if(type == PROMOTION) piece = IsWhite(piece) ? PW : PB;
 
-		if(move._end == G8 || move._end == G1)
-		{
-			Set(East(move._end), At(East(move._start)));
-			Set(East(move._start), EMPTY);
-			if(IsBlack(At(move._start))) _can_castle_b = true;
-			else _can_castle_w = true;
-		}
-		else
-		{
-			Set(West(West(move._end)), At(West(move._start)));
-			Set(West(move._start), EMPTY);
-			if(IsBlack(At(move._start))) _can_castle_b_q = true;
-			else _can_castle_w_q = true;
-		}
-	}
-	else if(move._type == ENPASSANT)
+	Set(start, piece);
+	if(type == ENPASSANT)
 	{
-		Set(move._start, At(move._end));
-		if(IsWhite(At(move._end))) Set(South(move._end), move._deleted);
-		else Set(North(move._end), move._deleted);
-		Set(move._end, EMPTY);
+		Set(end, EMPTY);
+		Set(IsWhite(piece) ? South(end) : North(end), undo._captured);
 	}
-	else if(move._type == PROMOTION)
+	else Set(end, undo._captured);
+
+	if(type == CASTLING)
 	{
-		if(IsBlack(move._inserted))
+		if(end == G8 || end == G1)
 		{
-			Set(move._start, PB);
-			Set(move._end, move._deleted);
+			Set(East(end), At(West(end)));
+			Set(West(end), EMPTY);
 		}
 		else
 		{
-			Set(move._start, PW);
-			Set(move._end, move._deleted);
+			Set(West(West(end)), At(East(end)));
+			Set(East(end), EMPTY);
 		}
 	}
 
+	SetCastleRights(undo._castle_rights);
+	_ep_square = undo._ep_square;
+	_half_move_clock = undo._half_move_clock;
+
 	_move_history.pop_back();
 	_move_count -= 1;
 
 	if(_current_color == COLOR_W) _full_move_clock--;
 
-	_half_move_clock--;
-	if(_half_move_clock < 0 && !_half_move_history.empty())
-	{
-		_half_move_clock = _half_move_history.back();
-		_half_move_history.pop_back();
-	}
+	if(_current_color == COLOR_W) _current_color = COLOR_B;
+	else _current_color = COLOR_W;
+
+	_hash = _hash_history.back();
+	_hash_history.pop_back();
+}
+
+void Board::MakeNullMove()
+{
+	_status_valid = false;
+
+	MoveUndo undo;
+	undo._move = MOVE_NONE;
+	undo._captured = EMPTY;
+	undo._castle_rights = GetCastleRights();
+	undo._ep_square = _ep_square;
+	undo._half_move_clock = _half_move_clock;
+	_move_history.push_back(undo);
+
+	_hash_history.push_back(_hash);
+	_hash ^= StateKey();
+
+	// A NULL MOVE IS NOT A REAL PLY, SO REPETITION SCANS MUST STOP HERE
+	_ep_square = SQUARE_NONE;
+	_half_move_clock = 0;
 
 	if(_current_color == COLOR_W) _current_color = COLOR_B;
 	else _current_color = COLOR_W;
+
+	_hash ^= StateKey();
 }
 
-std::vector<Move> Board::GetPseudoLegalMoves(uint8_t s)
+void Board::UnMakeNullMove()
 {
+	if(_move_history.size() <= 0)
+		return;
+	_status_valid = false;
 
-	std::vector<Move> moves;
+	MoveUndo undo = _move_history.back();
+	_ep_square = undo._ep_square;
+	_half_move_clock = undo._half_move_clock;
+	_move_history.pop_back();
 
-	if(s == SQUARE_NONE) return moves;
+	if(_current_color == COLOR_W) _current_color = COLOR_B;
+	else _current_color = COLOR_W;
 
+	_hash = _hash_history.back();
+	_hash_history.pop_back();
+}
+
+void Board::AddPieceMoves(uint8_t s, Bitboard targets, MoveList &moves)
+{
 	uint8_t piece = At(s);
 	uint8_t type = TypeOf(piece);
 	uint8_t color = ColorOf(piece);
 
-	uint8_t x, y, d;
+	if(type == PIECE_NONE) return;
+
+	Bitboard own = _color_bb[color];
+	Bitboard enemies = _color_bb[COLOR_ALL] & ~own;
+	targets &= ~own;
 
 	if(type == PAWN)
 	{
-		x = s%8;
-		y = s/8;
+		uint8_t forward = (color == COLOR_W) ? North(s) : South(s);
+		Bitboard captures = PawnAttacks[color][s] & enemies & targets;
+
 		//PROMOTION MOVE
-		if((color == COLOR_W && y == 1) || (color == COLOR_B && y == 6))
-		{
-			Move move;
-			move._start = s;
-			if(color == COLOR_W)
-			{
-				move._end = North(East(s));
-				if (IsValidSquare(move._end) && IsBlack(At(move._end)))
-				{
-					move._deleted = At(move._end);
-					move._type = PROMOTION;
-					move._inserted = BW;
-					moves.push_back(move);
-					move._inserted = QW;
-					moves.push_back(move);
-					move._inserted = RW;
-					moves.push_back(move);
-					move._inserted = NW;
-					moves.push_back(move);
-				}
-				move._end = North(West(s));
-				if (IsValidSquare(move._end) && IsBlack(At(move._end)))
-				{
-					move._deleted = At(move._end);
-					move._type = PROMOTION;
-					move._inserted = BW;
-					moves.push_back(move);
-					move._inserted = QW;
-					moves.push_back(move);
-					move._inserted = RW;
-					moves.push_back(move);
-					move._inserted = NW;
-					moves.push_back(move);
-				}
-				move._end = North(s);
-				if (IsValidSquare(move._end) && At(move._end) == EMPTY)
-				{
-					move._deleted = EMPTY;
-					move._type = PROMOTION;
-					move._inserted = BW;
-					moves.push_back(move);
-					move._inserted = QW;
-					moves.push_back(move);
-					move._inserted = RW;
-					moves.push_back(move);
-					move._inserted = NW;
-					moves.push_back(move);
-				}
-				
-				return moves;
-			}
-			else
-			{
-				move._end = South(East(s));
-				if(IsValidSquare(move._end) && IsWhite(At(move._end)))
-				{
-					move._deleted = At(move._end);
-					move._type = PROMOTION;
-					move._inserted = BB;
-					moves.push_back(move);
-					move._inserted = QB;
-					moves.push_back(move);
-					move._inserted = RB;
-					moves.push_back(move);
-					move._inserted = NB;
-					moves.push_back(move);
-				}
-				move._end = South(West(s));
-				if(IsValidSquare(move._end) && IsWhite(At(move._end)))
-				{
-					move._deleted = At(move._end);
-					move._type = PROMOTION;
-					move._inserted = BB;
-					moves.push_back(move);
-					move._inserted = QB;
-					moves.push_back(move);
-					move._inserted = RB;
-					moves.push_back(move);
-					move._inserted = NB;
-					moves.push_back(move);
-				}
-				move._end = South(s);
-				if(IsValidSquare(move._end) && At(move._end) == EMPTY)
-				{
-					move._deleted = At(move._end);
-					move._type = PROMOTION;
-					move._inserted = BB;
-					moves.push_back(move);
-					move._inserted = QB;
-					moves.push_back(move);
-					move._inserted = RB;
-					moves.push_back(move);
-					move._inserted = NB;
-					moves.push_back(move);
-				}
-				return moves;
-			}
-		}
-		//TWO STEP W
-		if(color == COLOR_W && y == 6 && At(North(North(s))) == EMPTY && At(North(s)) == EMPTY)
-		{
-			Move move;
-			move._start = s;
-			move._end = North(North(s));
-			move._type = TWOSTEP;
-			moves.push_back(move);
-		}
-		//TWO STEP B
-		if(color == COLOR_B && y == 1 && At(South(South(s))) == EMPTY && At(South(s)) == EMPTY)
+		if((color == COLOR_W && s/8 == 1) || (color == COLOR_B && s/8 == 6))
 		{
-			Move move;
-			move._start = s;
-			move._end = South(South(s));
-			move._type = TWOSTEP;
-			moves.push_back(move);
-		}
-		//EN PASSANT
-		if(_move_history.size() > 0)
-		{
-			Move prev_move = _move_history.back();
-			if(prev_move._type == TWOSTEP && ColorOf(At(prev_move._end)) != color)
-			{
-				if(West(s) == prev_move._end || East(s) == prev_move._end)
-				{
-					if(color == COLOR_B)
-					{
-						Move move;
-						move._start = s;
-						move._end = South(prev_move._end);
-						move._deleted = At(prev_move._end);
-						move._type = ENPASSANT;
-						moves.push_back(move);
-					}
-					else
-					{
-						Move move;
-						move._start = s;
-						move._end = North(prev_move._end);
-						move._deleted = At(prev_move._end);
-						move._type = ENPASSANT;
-						moves.push_back(move);
-					}
-				}
-			}
-		}
-	}
+			Bitboard ends = captures;
+			if(At(forward) == EMPTY) ends |= SquareBB(forward) & targets;
 
-	// L - MOVES
-	if(type == KNIGHT)
-	{
-		int xL[] = {2, 2, -2, -2, 1, 1, -1, -1};
-		int yL[] = {1, -1, 1, -1, 2, -2, 2, -2};
-		for(uint8_t i = 0; i < 8; ++i)
-		{
-			x = s%8 + xL[i];
-			y = s/8 + yL[i];
-			if((y >= 0 && y < 8) && (x >= 0 && x < 8) && ColorOf(At(x, y)) != color)
+			while(ends)
 			{
-				Move move;
-				move._start = s;
-				move._end = y*8+x;
-				move._type = NORMAL;
-				moves.push_back(move);
+				uint8_t end = PopLSB(ends);
+				moves.Add(PackMove(s, end, PROMOTION_Q));
+				moves.Add(PackMove(s, end, PROMOTION_R));
+				moves.Add(PackMove(s, end, PROMOTION_B));
+				moves.Add(PackMove(s, end, PROMOTION_N));
 			}
+			return;
 		}
-		return moves;
-	}
 
-	if(type == KING)
-	{
-		if((color == COLOR_B && _can_castle_b) || (color == COLOR_W && _can_castle_w))
-		{
-			if(!IsInAttack(s, color) && At(East(s)) == EMPTY && !IsInAttack(East(s), color) && At(East(East(s))) == EMPTY && !IsInAttack(East(East(s)), color))
-			{
-				Move move;
-				move._start = s;
-				move._end = East(East(s));
-				move._type = CASTLING;
-				moves.push_back(move);
-			}
-		}
-		if((color == COLOR_B && _can_castle_b_q) || (color == COLOR_W && _can_castle_w_q))
+		//ONE STEP
+		if(IsValidSquare(forward) && At(forward) == EMPTY)
 		{
-			if(!IsInAttack(s, color)  && At(West(s)) == EMPTY && !IsInAttack(West(s), color) && At(West(West(s))) == EMPTY && !IsInAttack(West(West(s)), color) && At(West(West(West(s)))) == EMPTY)
+			if(targets & SquareBB(forward)) moves.Add(PackMove(s, forward, NORMAL));
+
+			//TWO STEP
+			uint8_t twostep = (color == COLOR_W) ? North(forward) : South(forward);
+			if(((color == COLOR_W && s/8 == 6) || (color == COLOR_B && s/8 == 1)) && At(twostep) == EMPTY && (targets & SquareBB(twostep)))
 			{
-				Move move;
-				move._start = s;
-				move._end = West(West(s));
-				move._type = CASTLING;
-				moves.push_back(move);
+				moves.Add(PackMove(s, twostep, TWOSTEP));
 			}
 		}
+
+		targets = captures;
 	}
 
-	// EAST
-	x = s%8 + 1;
-	y = s/8;
-	d = 1;
-	while((type == ROOK || type == QUEEN || (type == KING && d == 1)) && (x >= 0 && x < 8))
+	// L - MOVES
+	else if(type == KNIGHT) targets &= KnightAttacks[s];
+
+	// SLIDING MOVES
+	else if(type == BISHOP) targets &= BishopAttacks(s, _color_bb[COLOR_ALL]);
+	else if(type == ROOK) targets &= RookAttacks(s, _color_bb[COLOR_ALL]);
+	else if(type == QUEEN) targets &= BishopAttacks(s, _color_bb[COLOR_ALL]) | RookAttacks(s, _color_bb[COLOR_ALL]);
+
+	else if(type == KING) targets &= KingAttacks[s];
+
+	while(targets)
 	{
-		if(At(x, y) != EMPTY)
-		{
-			if(ColorOf(At(x, y)) == color) break;
-			else
-			{
-				Move move;
-				move._start = s;
-				move._end = y*8+x;
-				move._type = NORMAL;
-				moves.push_back(move);
-				break;
-			}
-		}
-		else
-		{
-			Move move;
-			move._start = s;
-			move._end = y*8+x;
-			move._type = NORMAL;
-			moves.push_back(move);
-		}
-		x += 1;
-		d += 1;
+		moves.Add(PackMove(s, PopLSB(targets), NORMAL));
 	}
+}
 
-	// WEST
-	x = s%8 - 1;
-	y = s/8;
-	d = 1;
-	while((type == ROOK || type == QUEEN || (type == KING && d == 1)) && (x >= 0 && x < 8))
+void Board::AddEnPassantMoves(uint8_t s, MoveList &moves)
+{
+	if(!IsPawn(At(s)) || _ep_square == SQUARE_NONE) return;
+
+	// ONLY THE SIDE THAT DID NOT MAKE THE TWO STEP MOVE CAN TAKE, FROM RANK 5 FOR WHITE AND RANK 4 FOR BLACK
+	uint8_t color = ColorOf(At(s));
+	if((color == COLOR_W && _ep_square/8 != 2) || (color == COLOR_B && _ep_square/8 != 5)) return;
+
+	if(PawnAttacks[color][s] & SquareBB(_ep_square))
 	{
-		if(At(x, y) != EMPTY)
-		{
-			if(ColorOf(At(x, y)) == color) break;
-			else
-			{
-				Move move;
-				move._start = s;
-				move._end = y*8+x;
-				move._type = NORMAL;
-				moves.push_back(move);
-				break;
-			}
-		}
-		else
-		{
-			Move move;
-			move._start = s;
-			move._end = y*8+x;
-			move._type = NORMAL;
-			moves.push_back(move);
-		}
-		x -= 1;
-		d += 1;
+		moves.Add(PackMove(s, _ep_square, ENPASSANT));
 	}
+}
+
+void Board::AddCastlingMoves(uint8_t s, MoveList &moves)
+{
+	uint8_t color = ColorOf(At(s));
 
-	// SOUTH
-	x = s%8;
-	y = s/8 + 1;
-	d = 1;
-	while((type == ROOK || type == QUEEN || (type == KING && d == 1) || (type == PAWN && d == 1 && color == COLOR_B)) && (y >= 0 && y < 8))
+	if((color == COLOR_B && _can_castle_b) || (color == COLOR_W && _can_castle_w))
 	{
-		if(At(x, y) != EMPTY)
+		if(!IsInAttack(s, color) && At(East(s)) == EMPTY && !IsInAttack(East(s), color) && At(East(East(s))) == EMPTY && !IsInAttack(East(East(s)), color))
 		{
-			if(ColorOf(At(x, y)) == color || type == PAWN) break;
-			else
-			{
-				Move move;
-				move._start = s;
-				move._end = y*8+x;
-				move._type = NORMAL;
-				moves.push_back(move);
-				break;
-			}
+			moves.Add(PackMove(s, East(East(s)), CASTLING));
 		}
-		else
+	}
+	if((color == COLOR_B && _can_castle_b_q) || (color == COLOR_W && _can_castle_w_q))
+	{
+		if(!IsInAttack(s, color)  && At(West(s)) == EMPTY && !IsInAttack(West(s), color) && At(West(West(s))) == EMPTY && !IsInAttack(West(West(s)), color) && At(West(West(West(s)))) == EMPTY)
 		{
-			Move move;
-			move._start = s;
-			move._end = y*8+x;
-			move._type = NORMAL;
-			moves.push_back(move);
+			moves.Add(PackMove(s, West(West(s)), CASTLING));
 		}
-		y += 1;
-		d += 1;
 	}
+}
+
+void Board::GetPseudoLegalMoves(uint8_t s, MoveList &moves)
+{
+	if(!IsValidSquare(s)) return;
+
+	AddPieceMoves(s, ~0ULL, moves);
+	if(IsPawn(At(s))) AddEnPassantMoves(s, moves);
+	if(IsKing(At(s))) AddCastlingMoves(s, moves);
+}
+
+void Board::GetAllPseudoLegalMoves(uint8_t playerColor, MoveList &moves)
+{
+	if(playerColor != COLOR_B && playerColor != COLOR_W) return;
 
-	// NORTH
-	x = s%8;
-	y = s/8 - 1;
-	d = 1;
-	while((type == ROOK || type == QUEEN || (type == KING && d == 1) || (type == PAWN && d == 1 && color == COLOR_W)) && (y >= 0 && y < 8))
+	Bitboard pieces = _color_bb[playerColor];
+	while(pieces)
 	{
-		if(At(x, y) != EMPTY)
-		{
-			if(ColorOf(At(x, y)) == color || type == PAWN) break;
-			else
-			{
-				Move move;
-				move._start = s;
-				move._end = y*8+x;
-				move._type = NORMAL;
-				moves.push_back(move);
-				break;
-			}
-		}
-		else
-		{
-			Move move;
-			move._start = s;
-			move._end = y*8+x;
-			move._type = NORMAL;
-			moves.push_back(move);
-		}
-		y -= 1;
-		d += 1;
+		GetPseudoLegalMoves(PopLSB(pieces), moves);
 	}
+}
+
+void Board::FilterLegalMoves(uint8_t s, MoveList &moves)
+{
+	uint8_t piece = At(s);
+	uint8_t color = ColorOf(piece);
+
+	// PSEUDO LEGAL MOVES ARE APPENDED AND THEN FILTERED IN PLACE
+	uint16_t first = moves._size;
+	GetPseudoLegalMoves(s, moves);
+	uint16_t last = moves._size;
+	moves._size = first;
 
-	// NORTH-EAST
-	x = s%8 + 1;
-	y = s/8 - 1;
-	d = 1;
-	while((type == BISHOP || type == QUEEN || (type == KING && d == 1) || (type == PAWN && d == 1 && color == COLOR_W)) && (x >= 0 && x < 8) && (y >= 0 && y < 8))
+	for(uint16_t i = first; i < last; i++)
 	{
-		if(At(x, y) != EMPTY)
-		{
-			if(ColorOf(At(x, y)) == color) break;
-			else
-			{
-				Move move;
-				move._start = s;
-				move._end = y*8+x;
-				move._type = NORMAL;
-				moves.push_back(move);
-				break;
-			}
-		}
-		else
-		{
-			if(type != PAWN)
-			{
-				Move move;
-				move._start = s;
-				move._end = y*8+x;
-				move._type = NORMAL;
-				moves.push_back(move);
-			}
-		}
-		x += 1;
-		y -= 1;
-		d += 1;
+		PackedMove m = moves._moves[i];
+		MakeMove(m);
+		if(!IsInCheck(color)) moves.Add(m);
+		UnMakeMove();
 	}
+}
+
+void Board::GenerateLegalMoves(uint8_t color, Bitboard pieces, MoveList &moves)
+{
+	uint8_t enemy = (color == COLOR_W) ? COLOR_B : COLOR_W;
+	uint8_t king = GetKing(color);
+	Bitboard occupied = _color_bb[COLOR_ALL];
+	Bitboard checkers = AttackersTo(king, occupied) & _color_bb[enemy];
 
-	// NORTH-WEST
-	x = s%8 - 1;
-	y = s/8 - 1;
-	d = 1;
-	while((type == BISHOP || type == QUEEN || (type == KING && d == 1) || (type == PAWN && d == 1 && color == COLOR_W)) && (x >= 0 && x < 8) && (y >= 0 && y < 8))
+	pieces &= _color_bb[color];
+
+	// THE KING IS LIFTED OFF THE BOARD SO IT CANNOT SHIELD THE SQUARES BEHIND IT
+	if(pieces & SquareBB(king))
 	{
-		if(At(x, y) != EMPTY)
-		{
-			if(ColorOf(At(x, y)) == color) break;
-			else
-			{
-				Move move;
-				move._start = s;
-				move._end = y*8+x;
-				move._type = NORMAL;
-				moves.push_back(move);
-				break;
-			}
-		}
-		else
+		Bitboard targets = KingAttacks[king] & ~_color_bb[color];
+		while(targets)
 		{
-			if(type != PAWN)
-			{
-				Move move;
-				move._start = s;
-				move._end = y*8+x;
-				move._type = NORMAL;
-				moves.push_back(move);
-			}
+			uint8_t t = PopLSB(targets);
+			if(AttackersTo(t, occupied ^ SquareBB(king)) & _color_bb[enemy]) continue;
+
+			moves.Add(PackMove(king, t, NORMAL));
 		}
-		x -= 1;
-		y -= 1;
-		d += 1;
+		if(!checkers) AddCastlingMoves(king, moves);
 	}
 
-	// SOUTH-EAST
-	x = s%8 + 1;
-	y = s/8 + 1;
-	d = 1;
-	while((type == BISHOP || type == QUEEN || (type == KING && d == 1) || (type == PAWN && d == 1 && color == COLOR_B)) && (x >= 0 && x < 8) && (y >= 0 && y < 8))
+	// ONLY THE KING MAY MOVE OUT OF A DOUBLE CHECK
+	if(PopCount(checkers) > 1) return;
+
+	// A SINGLE CHECK MUST BE CAPTURED OR BLOCKED
+	Bitboard allowed = ~0ULL;
+	if(checkers) allowed = Between[king][LSB(checkers)] | checkers;
+
+	// PIECES PINNED TO THE KING MAY ONLY MOVE ALONG THE PIN LINE
+	Bitboard pinned = 0;
+	Bitboard snipers = (RookAttacks(king, 0) & (_piece_bb[RB+(enemy == COLOR_W)*(RW-RB)] | _piece_bb[QB+(enemy == COLOR_W)*(QW-QB)]))
+		| (BishopAttacks(king, 0) & (_piece_bb[BB+(enemy == COLOR_W)*(BW-BB)] | _piece_bb[QB+(enemy == COLOR_W)*(QW-QB)]));
+	while(snipers)
 	{
-		if(At(x, y) != EMPTY)
-		{
-			if(ColorOf(At(x, y)) == color) break;
-			else
-			{
-				Move move;
-				move._start = s;
-				move._end = y*8+x;
-				move._type = NORMAL;
-				moves.push_back(move);
-				break;
-			}
-		}
-		else
-		{
-			if(type != PAWN)
-			{
-				Move move;
-				move._start = s;
-				move._end = y*8+x;
-				move._type = NORMAL;
-				moves.push_back(move);
-			}
-		}
-		x += 1;
-		y += 1;
-		d += 1;
+		Bitboard blockers = Between[king][PopLSB(snipers)] & occupied;
+		if(PopCount(blockers) == 1 && (blockers & _color_bb[color])) pinned |= blockers;
 	}
 
-	// SOUTH-WEST
-	x = s%8 - 1;
-	y = s/8 + 1;
-	d = 1;
-	while((type == BISHOP || type == QUEEN || (type == KING && d == 1) || (type == PAWN && d == 1 && color == COLOR_B)) && (x >= 0 && x < 8) && (y >= 0 && y < 8))
+	pieces &= ~SquareBB(king);
+	while(pieces)
 	{
-		if(At(x, y) != EMPTY)
-		{
-			if(ColorOf(At(x, y)) == color) break;
-			else
-			{
-				Move move;
-				move._start = s;
-				move._end = y*8+x;
-				move._type = NORMAL;
-				moves.push_back(move);
-				break;
-			}
-		}
-		else
+		uint8_t s = PopLSB(pieces);
+		Bitboard targets = allowed;
+		if(pinned & SquareBB(s)) targets &= Line[king][s];
+		AddPieceMoves(s, targets, moves);
+
+		// EN PASSANT REMOVES TWO PIECES FROM ONE RANK, SO IT IS CHECKED AGAINST THE RESULTING OCCUPANCY
+		if(IsPawn(At(s)))
 		{
-			if(type != PAWN)
+			uint16_t first = moves._size;
+			AddEnPassantMoves(s, moves);
+			if(moves._size > first)
 			{
-				Move move;
-				move._start = s;
-				move._end = y*8+x;
-				move._type = NORMAL;
-				moves.push_back(move);
+				uint8_t captured = (color == COLOR_W) ? South(_ep_square) : North(_ep_square);
+				Bitboard after = (occupied ^ SquareBB(s) ^ SquareBB(captured)) | SquareBB(_ep_square);
+				if(AttackersTo(king, after) & _color_bb[enemy] & ~SquareBB(captured)) moves._size = first;
 			}
 		}
-		x -= 1;
-		y += 1;
-		d += 1;
 	}
+}
+
+void Board::GetLegalMoves(uint8_t s, MoveList &moves)
+{
+	if(!IsValidSquare(s) || At(s) == EMPTY) return;
 
-	return moves;
+	if(_make_move_legality) FilterLegalMoves(s, moves);
+	else GenerateLegalMoves(ColorOf(At(s)), SquareBB(s), moves);
 }
 
-std::vector<Move> Board::GetAllPseudoLegalMoves(uint8_t playerColor)
+void Board::GetAllLegalMoves(uint8_t playerColor, MoveList &moves)
 {
-	std::vector<Move> moves;
+	if(playerColor == COLOR_NONE || playerColor == COLOR_ALL) return;
 
-	if(playerColor != COLOR_B && playerColor != COLOR_W) return moves;
+	if(!_make_move_legality)
+	{
+		GenerateLegalMoves(playerColor, _color_bb[playerColor], moves);
+		return;
+	}
 
-	for(uint8_t s = 0; s < 64; s++)
+	Bitboard pieces = _color_bb[playerColor];
+	while(pieces)
 	{
-		uint8_t piece = At(uint8_t(s));
-		uint8_t color = ColorOf(piece);
-		if(color == playerColor)
-		{
-			std::vector<Move> pseudoMoves = GetPseudoLegalMoves(uint8_t(s));
-			moves.insert(moves.end(), pseudoMoves.begin(), pseudoMoves.end());
-		}
+		FilterLegalMoves(PopLSB(pieces), moves);
 	}
-	return moves;
 }
 
-std::vector<Move> Board::GetLegalMoves(uint8_t s)
+std::vector<Move> Board::UnpackMoves(MoveList &moves)
 {
-	uint8_t piece = At(s);
-	uint8_t color = ColorOf(piece);
-
-	std::vector<Move> pseudoMoves = GetPseudoLegalMoves(s);
-	std::vector<Move> moves;
-
-	for(int i = 0; i < pseudoMoves.size(); i++)
+	std::vector<Move> unpacked(moves.Size());
+	for(uint16_t i = 0; i < moves.Size(); i++)
 	{
-		Move m = pseudoMoves[i];
-		MakeMove(m);
-		if(!IsInCheck(color)) moves.push_back(m);
-		UnMakeMove();
+		unpacked[i] = UnpackMove(moves[i]);
 	}
-	return moves;
+	return unpacked;
 }
 
-std::vector<Move> Board::GetAllLegalMoves(uint8_t playerColor)
+std::vector<Move> Board::GetPseudoLegalMoves(uint8_t s)
+{
+	MoveList moves;
+	GetPseudoLegalMoves(s, moves);
+	return UnpackMoves(moves);
+}
+
+std::vector<Move> Board::GetAllPseudoLegalMoves(uint8_t playerColor)
 {
-	std::vector<Move> moves;
+	MoveList moves;
+	GetAllPseudoLegalMoves(playerColor, moves);
+	return UnpackMoves(moves);
+}
 
-	if(playerColor == COLOR_NONE || playerColor == COLOR_ALL) return moves;
+std::vector<Move> Board::GetLegalMoves(uint8_t s)
+{
+	MoveList moves;
+	GetLegalMoves(s, moves);
+	return UnpackMoves(moves);
+}
 
-	for(uint8_t s = 0; s < 64; s++)
-	{
-		uint8_t piece = At(uint8_t(s));
-		uint8_t color = ColorOf(piece);
-		if(color == playerColor)
-		{
-			std::vector<Move> m = GetLegalMoves(uint8_t(s));
-			moves.insert(moves.end(), m.begin(), m.end());
-		}
-	}
-	return moves;
+std::vector<Move> Board::GetAllLegalMoves(uint8_t playerColor)
+{
+	MoveList moves;
+	GetAllLegalMoves(playerColor, moves);
+	return UnpackMoves(moves);
 }
 
 std::string Board::GetFENString()
@@ -1197,15 +1159,10 @@ std::string Board::GetFENString()
 	if(!_can_castle_b && !_can_castle_b_q) fen += '-';
 	fen += ' ';
 
-	if(_move_history.size() > 0 && _move_history.back()._type == TWOSTEP)
+	if(_ep_square != SQUARE_NONE)
 	{
-		Move move = _move_history.back();
-		int s;
-		if(ColorOf(At(move._end)) == COLOR_W) s = South(move._end);
-		else s = North(move._end);
-
-		fen += char('a'+s%8);
-		fen += char('0'+(8-s/8));
+		fen += char('a'+_ep_square%8);
+		fen += char('0'+(8-_ep_square/8));
 	}
 	else fen += '-';
 	fen += ' ';
@@ -1220,10 +1177,12 @@ std::string Board::GetFENString()
 
 void Board::SetPositionFromFENString(std::string fen)
 {
+	_status_valid = false;
 	_can_castle_w = false;
 	_can_castle_w_q = false;
 	_can_castle_b = false;
 	_can_castle_b_q = false;
+	_ep_square = SQUARE_NONE;
 	_move_count = 0;
 	_move_history.clear();
 
@@ -1298,6 +1257,7 @@ void Board::SetPositionFromFENString(std::string fen)
 		}
 		i++;
 	}
+	ComputeBitboards();
 
 	ss>>word;
 	if(word[0] == 'b') _current_color = COLOR_B;
@@ -1326,83 +1286,322 @@ void Board::SetPositionFromFENString(std::string fen)
 	}
 
 	ss>>word;
-	if(word[0] == '-') i++;
-	else
-	{
-		s = ('8'-word[1])*8+(word[0]-'a');
-		Move move;
-		move._type = TWOSTEP;
-		if(_current_color == COLOR_W)
-		{
-			move._start = North(s);
-			move._end = South(s);
-		}
-		else
-		{
-			move._start = South(s);
-			move._end = North(s);
-		}
-		_move_history.push_back(move);
-		_move_count = 1;
-	}
+	if(word[0] != '-') _ep_square = ('8'-word[1])*8+(word[0]-'a');
 
 	ss>>word;
 	_half_move_clock = std::stoi(word);
 
 	ss>>word;
 	_full_move_clock = std::stoi(word);
+
+	ComputeHash();
 }
 
-Move Board::GetMoveFromString(std::string move)
+PackedMove Board::GetPackedMoveFromString(std::string move)
 {
+	if(move.size() < 4) return MOVE_NONE;
 	if(move[0] >= 'a' && move[0] <= 'z') move[0] = 'A'+move[0]-'a';
 	if(move[2] >= 'a' && move[2] <= 'z') move[2] = 'A'+move[2]-'a';
 
 	int start = ('8'-move[1])*8+(move[0]-'A');
 	int end = ('8'-move[3])*8+(move[2]-'A');
+	if(!IsValidSquare(start) || !IsValidSquare(end)) return MOVE_NONE;
 
-	std::vector<Move> moves = GetLegalMoves(start);
-	for(Move m : moves)
+	MoveList moves;
+	GetLegalMoves(start, moves);
+	for(PackedMove m : moves)
 	{
-		if(m._end == end)
+		if(MoveEnd(m) == end)
 		{
-			if(m._type == PROMOTION)
+			if(MoveType(m) == PROMOTION)
 			{
-				if(move[4] == 'q' && TypeOf(m._inserted) == QUEEN)
+				if(move[4] == 'q' && MoveFlags(m) == PROMOTION_Q)
 					return m;
-				else if(move[4] == 'n' && TypeOf(m._inserted) == KNIGHT)
+				else if(move[4] == 'n' && MoveFlags(m) == PROMOTION_N)
 					return m;
-				else if(move[4] == 'r' && TypeOf(m._inserted) == ROOK)
+				else if(move[4] == 'r' && MoveFlags(m) == PROMOTION_R)
 					return m;
-				else if(move[4] == 'b' && TypeOf(m._inserted) == BISHOP)
+				else if(move[4] == 'b' && MoveFlags(m) == PROMOTION_B)
 					return m;
 			}
 			else return m;
 		}
 	}
-	
-	return Move();
+
+	return MOVE_NONE;
+}
+
+Move Board::GetMoveFromString(std::string move)
+{
+	PackedMove packed = GetPackedMoveFromString(move);
+	if(packed == MOVE_NONE) return Move();
+	return UnpackMove(packed);
 }
 
 void Board::MakeMove(std::string move)
 {
-	MakeMove(GetMoveFromString(move));
+	PackedMove packed = GetPackedMoveFromString(move);
+	if(packed != MOVE_NONE) MakeMove(packed);
+}
+
+// STANDARD ALGEBRAIC NOTATION OF A LEGAL MOVE IN THIS POSITION. THE CHECK SUFFIX COSTS A MAKE/UNMAKE
+std::string Board::GetSANString(PackedMove move, bool check_suffix)
+{
+	static const char Letters[6] = {'B', 'K', 'N', 'P', 'Q', 'R'};	// [TYPE]
+
+	uint8_t start = MoveStart(move);
+	uint8_t end = MoveEnd(move);
+	uint8_t piece = _squares[start];
+	std::string san;
+
+	if(MoveType(move) == CASTLING)
+	{
+		san = (end%8 > start%8) ? "O-O" : "O-O-O";
+	}
+	else
+	{
+		bool capture = (_squares[end] != EMPTY || MoveType(move) == ENPASSANT);
+		if(TypeOf(piece) == PAWN)
+		{
+			if(capture) san += char('a'+start%8);
+		}
+		else
+		{
+			san += Letters[TypeOf(piece)];
+
+			// NAME THE START FILE, ELSE RANK, ELSE BOTH, WHEN ANOTHER PIECE OF THE SAME KIND CAN GO THERE TOO
+			MoveList moves;
+			GetAllLegalMoves(_current_color, moves);
+			bool ambiguous = false, same_file = false, same_rank = false;
+			for(PackedMove other : moves)
+			{
+				uint8_t other_start = MoveStart(other);
+				if(other_start == start || MoveEnd(other) != end || _squares[other_start] != piece) continue;
+				ambiguous = true;
+				if(other_start%8 == start%8) same_file = true;
+				if(other_start/8 == start/8) same_rank = true;
+			}
+			if(ambiguous)
+			{
+				if(!same_file) san += char('a'+start%8);
+				else if(!same_rank) san += char('8'-start/8);
+				else
+				{
+					san += char('a'+start%8);
+					san += char('8'-start/8);
+				}
+			}
+		}
+		if(capture) san += 'x';
+		san += char('a'+end%8);
+		san += char('8'-end/8);
+
+		switch(MoveFlags(move))
+		{
+			case PROMOTION_Q:
+				san += "=Q";
+				break;
+			case PROMOTION_R:
+				san += "=R";
+				break;
+			case PROMOTION_B:
+				san += "=B";
+				break;
+			case PROMOTION_N:
+				san += "=N";
+				break;
+		}
+	}
+
+	if(check_suffix)
+	{
+		MakeMove(move);
+		if(IsInCheck(_current_color))
+		{
+			MoveList replies;
+			GetAllLegalMoves(_current_color, replies);
+			san += (replies.Size() == 0) ? '#' : '+';
+		}
+		UnMakeMove();
+	}
+	return san;
+}
+
+// ACCEPTS SAN WITH OR WITHOUT CHECK MARKS, ANNOTATIONS AND THE PROMOTION '=', OR COORDINATES. DECODES THE
+// TEXT ONCE AND MATCHES IT AGAINST ONE LEGAL MOVE LIST, SO READING A LONG GAME COLLECTION STAYS CHEAP
+PackedMove Board::GetPackedMoveFromSAN(std::string san)
+{
+	std::string text;
+	for(char c : san)
+	{
+		if(c == '+' || c == '#' || c == '!' || c == '?' || c == '=' || c == 'x' || c == ':') continue;
+		text += (c == '0') ? 'O' : c;
+	}
+	if(text.empty()) return MOVE_NONE;
+
+	bool coordinates = san.size() >= 4 && san[0] >= 'a' && san[0] <= 'h' && san[1] >= '1' && san[1] <= '8'
+		&& san[2] >= 'a' && san[2] <= 'h' && san[3] >= '1' && san[3] <= '8';
+	if(coordinates)
+	{
+		if(san.size() > 4) san[4] = tolower(san[4]);
+		return GetPackedMoveFromString(san);
+	}
+
+	MoveList moves;
+	GetAllLegalMoves(_current_color, moves);
+
+	if(text == "O-O" || text == "O-O-O")
+	{
+		for(PackedMove move : moves)
+		{
+			if(MoveType(move) != CASTLING) continue;
+			if((MoveEnd(move)%8 > MoveStart(move)%8) == (text == "O-O")) return move;
+		}
+		return MOVE_NONE;
+	}
+
+	uint8_t type = PAWN;
+	size_t first = 0;
+	switch(text[0])
+	{
+		case 'K': type = KING; first = 1; break;
+		case 'Q': type = QUEEN; first = 1; break;
+		case 'R': type = ROOK; first = 1; break;
+		case 'B': type = BISHOP; first = 1; break;
+		case 'N': type = KNIGHT; first = 1; break;
+	}
+
+	uint8_t flags = NORMAL;
+	size_t last = text.size();
+	// THE PROMOTION LETTER COMES RIGHT AFTER THE LAST RANK IN EITHER CASE, WHICH TELLS "b" THE BISHOP FROM "b" THE FILE
+	if(type == PAWN && last > 2 && (text[last-2] == '1' || text[last-2] == '8'))
+	{
+		switch(tolower(text[last-1]))
+		{
+			case 'q': flags = PROMOTION_Q; break;
+			case 'r': flags = PROMOTION_R; break;
+			case 'b': flags = PROMOTION_B; break;
+			case 'n': flags = PROMOTION_N; break;
+		}
+		if(flags != NORMAL) last--;
+	}
+
+	if(last < first+2) return MOVE_NONE;
+	char end_file = text[last-2], end_rank = text[last-1];
+	if(end_file < 'a' || end_file > 'h' || end_rank < '1' || end_rank > '8') return MOVE_NONE;
+	uint8_t end = ('8'-end_rank)*8 + (end_file-'a');
+
+	// WHAT IS LEFT BETWEEN THE PIECE AND THE DESTINATION NAMES THE START FILE, RANK OR BOTH
+	int8_t start_file = -1, start_rank = -1;
+	for(size_t i = first; i < last-2; i++)
+	{
+		if(text[i] >= 'a' && text[i] <= 'h') start_file = text[i]-'a';
+		else if(text[i] >= '1' && text[i] <= '8') start_rank = '8'-text[i];
+		else return MOVE_NONE;
+	}
+	// A PAWN THAT NAMES NO FILE IS PUSHED STRAIGHT AHEAD
+	if(type == PAWN && start_file < 0) start_file = end%8;
+
+	PackedMove found = MOVE_NONE;
+	for(PackedMove move : moves)
+	{
+		uint8_t start = MoveStart(move);
+		if(MoveEnd(move) != end || TypeOf(_squares[start]) != type) continue;
+		if(start_file >= 0 && start%8 != start_file) continue;
+		if(start_rank >= 0 && start/8 != start_rank) continue;
+		if(MoveType(move) == PROMOTION ? MoveFlags(move) != flags : flags != NORMAL) continue;
+
+		if(found != MOVE_NONE) return MOVE_NONE;	// AMBIGUOUS
+		found = move;
+	}
+	return found;
+}
+
+std::string GetMoveString(PackedMove move)
+{
+	std::string str;
+	if(move == MOVE_NONE) return "0000";
+
+	str += char('a'+MoveStart(move)%8);
+	str += char('8'-MoveStart(move)/8);
+	str += char('a'+MoveEnd(move)%8);
+	str += char('8'-MoveEnd(move)/8);
+	switch(MoveFlags(move))
+	{
+		case PROMOTION_Q:
+			str += 'q';
+			break;
+		case PROMOTION_R:
+			str += 'r';
+			break;
+		case PROMOTION_B:
+			str += 'b';
+			break;
+		case PROMOTION_N:
+			str += 'n';
+			break;
+	}
+	return str;
+}
+
+std::string GetMoveString(Move move)
+{
+	if(!IsValidSquare(move._start) || !IsValidSquare(move._end)) return "0000";
+	return GetMoveString(PackMove(move));
 }
 
 std::vector<uint8_t> Board::GetPieceCount()
 {
 	std::vector<uint8_t> count(13, 0);
-	for(int i = 0; i < 64; i++)
+	for(uint8_t p = EMPTY; p <= PW; p++)
+	{
+		count[p] = _piece_count[p];
+	}
+	return count;
+}
+
+uint8_t Board::GetPieceCount(uint8_t piece)
+{
+	if(!IsValid(piece)) return 0;
+	return _piece_count[piece];
+}
+
+int32_t Board::GetMaterial(uint8_t color)
+{
+	if(color == COLOR_ALL) return _material[COLOR_W] - _material[COLOR_B];
+	return _material[color];
+}
+
+uint8_t Board::GetRepetitionCount()
+{
+	// POSITIONS BEFORE THE LAST CAPTURE OR PAWN MOVE CAN NEVER COME BACK, SO THE
+	// SCAN STOPS AT THE HALF MOVE CLOCK AND ONLY VISITS PLIES WITH THE SAME SIDE TO MOVE
+	uint8_t count = 1;
+	int32_t size = _hash_history.size();
+	int32_t limit = (_half_move_clock < size) ? _half_move_clock : size;
+	for(int32_t i = 4; i <= limit; i += 2)
 	{
-		count[_squares[i]]++;
+		if(_hash_history[size-i] == _hash) count++;
 	}
 	return count;
 }
 
 bool Board::IsGameFinished()
 {
-	std::vector<Move> moves = GetAllLegalMoves(_current_color);
-	if(moves.size() == 0)
+	// THE UI ASKS EVERY FRAME, ONLY REGENERATE WHEN THE POSITION CHANGED SINCE THE LAST ANSWER
+	if(_status_valid && _status_hash == _hash) return _status_finished;
+
+	_status_finished = ComputeGameStatus();
+	_status_hash = _hash;
+	_status_valid = true;
+	return _status_finished;
+}
+
+bool Board::ComputeGameStatus()
+{
+	MoveList moves;
+	GetAllLegalMoves(_current_color, moves);
+	if(moves.Size() == 0)
 	{
 		if(IsInCheck(_current_color))
 		{
@@ -1417,19 +1616,16 @@ bool Board::IsGameFinished()
 		_game_end_type = FIFTY_MOVE;
 		return true;
 	}
+	else if(GetRepetitionCount() >= 3)
+	{
+		_game_end_type = THREEFOLD_REPETITION;
+		return true;
+	}
 	else
 	{
-		std::vector<uint8_t> count = GetPieceCount();
-		uint8_t total_b = 0;
-		uint8_t total_w = 0;
-		for(uint8_t i = RB; i <= PB; i++)
-		{
-			total_b += count[i];
-		}
-		for(uint8_t i = RW; i <= PW; i++)
-		{
-			total_w += count[i];
-		}
+		uint8_t *count = _piece_count;
+		uint8_t total_b = PopCount(_color_bb[COLOR_B]);
+		uint8_t total_w = PopCount(_color_bb[COLOR_W]);
 		if(/*BLACK COUNT*/((total_b == 1 && count[KB] == 1) || (total_b == 2 && count[KB] == 1 && (count[NB] == 1 || count[BB] == 1)))/*BLACK COUNT*/ && /*WHITE COUNT*/((total_w == 1 && count[KW] == 1) || (total_w == 2 && count[KW] == 1 && (count[NW] == 1 || count[BW] == 1)))/*WHITE COUNT*/)
 		{
 			_game_end_type = DEAD_POSITION;
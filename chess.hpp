@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <string>
+#include <cstdint>
 
 // SQUARE INDICES MAPPING
 #define A8 0
@@ -163,6 +164,86 @@ inline bool IsValidSquare(uint8_t square)
 	return (square < 64 && square >= 0);
 }
 
+// BITBOARDS - BIT i IS SET FOR SQUARE INDEX i
+typedef uint64_t Bitboard;
+
+#define FILE_A_BB 0x0101010101010101ULL
+#define FILE_H_BB (FILE_A_BB << 7)
+#define RANK_8_BB 0x00000000000000FFULL
+#define RANK_1_BB (RANK_8_BB << 56)
+
+inline Bitboard SquareBB(uint8_t square)
+{
+	return 1ULL << square;
+}
+inline uint8_t LSB(Bitboard bb)
+{
+	return __builtin_ctzll(bb);
+}
+inline uint8_t MSB(Bitboard bb)
+{
+	return 63 - __builtin_clzll(bb);
+}
+inline uint8_t PopLSB(Bitboard &bb)
+{
+	uint8_t square = LSB(bb);
+	bb &= bb - 1;
+	return square;
+}
+inline uint8_t PopCount(Bitboard bb)
+{
+	return __builtin_popcountll(bb);
+}
+
+extern Bitboard KnightAttacks[64];
+extern Bitboard KingAttacks[64];
+extern Bitboard PawnAttacks[4][64]; // [COLOR][SQUARE]
+extern Bitboard Between[64][64];	// SQUARES STRICTLY BETWEEN TWO ALIGNED SQUARES
+extern Bitboard Line[64][64];		// FULL BOARD LINE THROUGH TWO ALIGNED SQUARES
+
+// SLIDING ATTACKS ARE LOOKED UP BY BLOCKER OCCUPANCY, INDEXED WITH PEXT WHEN THE CPU HAS BMI2
+// AND WITH A MAGIC MULTIPLICATION OTHERWISE
+struct Magic
+{
+	Bitboard _mask;
+	Bitboard _magic;
+	Bitboard *_attacks;
+	uint8_t _shift;
+
+	uint32_t Index(Bitboard occupied) const;
+};
+
+extern Magic RookMagics[64];
+extern Magic BishopMagics[64];
+extern bool UsePext;
+
+void InitBitboards();
+uint32_t PextIndex(Bitboard occupied, Bitboard mask);
+
+inline uint32_t Magic::Index(Bitboard occupied) const
+{
+	if(UsePext) return PextIndex(occupied, _mask);
+	return ((occupied & _mask) * _magic) >> _shift;
+}
+inline Bitboard RookAttacks(uint8_t square, Bitboard occupied)
+{
+	return RookMagics[square]._attacks[RookMagics[square].Index(occupied)];
+}
+inline Bitboard BishopAttacks(uint8_t square, Bitboard occupied)
+{
+	return BishopMagics[square]._attacks[BishopMagics[square].Index(occupied)];
+}
+
+// ZOBRIST KEYS
+extern uint64_t ZobristPieces[13][64];	// [PIECE][SQUARE], ZERO FOR EMPTY
+extern uint64_t ZobristCastle[4];		// K, Q, k, q
+extern uint64_t ZobristEnPassant[8];	// [FILE]
+extern uint64_t ZobristSide;			// BLACK TO MOVE
+
+void InitZobrist();
+
+extern const int32_t PieceValue[13];
+
 // MOVE TYPES
 #define NORMAL 0
 #define TWOSTEP 1
@@ -175,6 +256,7 @@ inline bool IsValidSquare(uint8_t square)
 #define STALEMATE 1
 #define DEAD_POSITION 2
 #define FIFTY_MOVE 3
+#define THREEFOLD_REPETITION 4
 
 // MOVE STRUCTURE DEFINING A SINGLE MOVE
 struct Move
@@ -186,12 +268,92 @@ struct Move
 	uint8_t _deleted = INVALID;
 };
 
+// PACKED 16 BIT MOVE USED BY GENERATION AND SEARCH
+// BITS 0-5 START SQUARE, BITS 6-11 END SQUARE, BITS 12-15 FLAGS
+// FLAGS ARE THE MOVE TYPE, EXCEPT PROMOTIONS WHICH USE PROMOTION + (QUEEN, ROOK, BISHOP, KNIGHT)
+typedef uint16_t PackedMove;
+
+#define MOVE_NONE 0
+#define PROMOTION_Q (PROMOTION+0)
+#define PROMOTION_R (PROMOTION+1)
+#define PROMOTION_B (PROMOTION+2)
+#define PROMOTION_N (PROMOTION+3)
+
+inline PackedMove PackMove(uint8_t start, uint8_t end, uint8_t flags)
+{
+	return start | (end << 6) | (flags << 12);
+}
+inline uint8_t MoveStart(PackedMove move)
+{
+	return move & 63;
+}
+inline uint8_t MoveEnd(PackedMove move)
+{
+	return (move >> 6) & 63;
+}
+inline uint8_t MoveFlags(PackedMove move)
+{
+	return move >> 12;
+}
+inline uint8_t MoveType(PackedMove move)
+{
+	return (MoveFlags(move) >= PROMOTION) ? PROMOTION : MoveFlags(move);
+}
+PackedMove PackMove(Move move);
+
+// UNDO RECORD PUSHED BY MakeMove, HOLDING WHAT THE PACKED MOVE CANNOT RECOVER
+struct MoveUndo
+{
+	PackedMove _move;
+	uint8_t _captured;
+	uint8_t _castle_rights;	// BIT 0 K, BIT 1 Q, BIT 2 k, BIT 3 q
+	uint8_t _ep_square;
+	int32_t _half_move_clock;
+};
+
+// FIXED CAPACITY MOVE BUFFER, LARGE ENOUGH FOR ANY REACHABLE POSITION
+#define MAX_MOVES 256
+
+struct MoveList
+{
+	PackedMove _moves[MAX_MOVES];
+	uint16_t _size = 0;
+
+	void Add(PackedMove move)
+	{
+		_moves[_size++] = move;
+	}
+	void Clear()
+	{
+		_size = 0;
+	}
+	uint16_t Size() const
+	{
+		return _size;
+	}
+	PackedMove &operator[](uint16_t i)
+	{
+		return _moves[i];
+	}
+	PackedMove *begin()
+	{
+		return _moves;
+	}
+	PackedMove *end()
+	{
+		return _moves + _size;
+	}
+};
+
 struct Board
 {
 	uint8_t _squares[64];
-	std::vector<Move> _move_history;
+	Bitboard _piece_bb[13];	// [PIECE], _piece_bb[EMPTY] HOLDS THE EMPTY SQUARES
+	Bitboard _color_bb[4];	// [COLOR], _color_bb[COLOR_ALL] HOLDS THE OCCUPIED SQUARES
+	uint8_t _piece_count[13];	// [PIECE]
+	int32_t _material[4];		// [COLOR], SUM OF PieceValue
+	std::vector<MoveUndo> _move_history;
 	uint32_t _move_count;
-	std::vector<uint32_t> _half_move_history;
 	int32_t _half_move_clock;
 	int32_t _full_move_clock;
 	uint8_t _current_color;
@@ -199,18 +361,26 @@ struct Board
 	uint8_t _kw_square;
 	uint8_t _kb_square;
 
-	uint32_t _uncastle_move_w;
-	uint32_t _uncastle_move_w_q;
-	uint32_t _uncastle_move_b;
-	uint32_t _uncastle_move_b_q;
-
 	bool _can_castle_w;
 	bool _can_castle_w_q;
 	bool _can_castle_b;
 	bool _can_castle_b_q;
 
+	uint8_t _ep_square;	// SQUARE SKIPPED BY THE LAST TWO STEP PAWN MOVE, SQUARE_NONE OTHERWISE
+
 	uint8_t _game_end_type;
 
+	// CACHED RESULT OF IsGameFinished, CLEARED BY MakeMove, UnMakeMove, Reset AND SetPositionFromFENString
+	bool _status_valid;
+	bool _status_finished;
+	uint64_t _status_hash;
+
+	uint64_t _hash;
+	std::vector<uint64_t> _hash_history;
+
+	// FILTER LEGAL MOVES BY MAKE/UNMAKE INSTEAD OF CHECKS AND PINS, KEPT SO PERFT CAN CROSS-CHECK THEM
+	bool _make_move_legality;
+
 	Board();
 	void Reset();
 
@@ -218,14 +388,40 @@ struct Board
 	uint8_t At(uint8_t x, uint8_t y);
 	void Set(uint8_t square, uint8_t piece);
 	uint8_t GetKing(uint8_t color);
+	void ComputeBitboards();
+	uint64_t StateKey();
+	void ComputeHash();
 	std::vector<uint8_t> GetPieceCount();
+	uint8_t GetPieceCount(uint8_t piece);
+	int32_t GetMaterial(uint8_t color);	// COLOR_ALL GIVES WHITE MINUS BLACK
+
+	uint8_t GetCastleRights();
+	void SetCastleRights(uint8_t rights);
+	Move UnpackMove(PackedMove move);
 
+	void MakeMove(PackedMove move);
 	void MakeMove(Move move);
 	void UnMakeMove();
+	void MakeNullMove();	// PASSES THE TURN, ONLY FOR SEARCH
+	void UnMakeNullMove();
 
+	Bitboard AttackersTo(uint8_t square, Bitboard occupied);
 	bool IsInAttack(uint8_t square, uint8_t color);
 	bool IsInCheck(uint8_t color);
 
+	void AddPieceMoves(uint8_t square, Bitboard targets, MoveList &moves);
+	void AddEnPassantMoves(uint8_t square, MoveList &moves);
+	void AddCastlingMoves(uint8_t square, MoveList &moves);
+	void FilterLegalMoves(uint8_t square, MoveList &moves);
+	void GenerateLegalMoves(uint8_t color, Bitboard pieces, MoveList &moves);
+
+	// THE MOVELIST OVERLOADS APPEND TO THE CALLER'S BUFFER WITHOUT ALLOCATING
+	void GetPseudoLegalMoves(uint8_t square, MoveList &moves);
+	void GetAllPseudoLegalMoves(uint8_t player, MoveList &moves);
+	void GetLegalMoves(uint8_t square, MoveList &moves);
+	void GetAllLegalMoves(uint8_t player, MoveList &moves);
+
+	std::vector<Move> UnpackMoves(MoveList &moves);
 	std::vector<Move> GetPseudoLegalMoves(uint8_t square);
 	std::vector<Move> GetAllPseudoLegalMoves(uint8_t player);
 	std::vector<Move> GetLegalMoves(uint8_t square);
@@ -233,12 +429,20 @@ struct Board
 
 	void SetPositionFromFENString(std::string fen);
 	std::string GetFENString();
+	PackedMove GetPackedMoveFromString(std::string move);
 	Move GetMoveFromString(std::string move);
 	void MakeMove(std::string move);
+	std::string GetSANString(PackedMove move, bool check_suffix = true);
+	PackedMove GetPackedMoveFromSAN(std::string san);
 
+	uint8_t GetRepetitionCount();
+	bool ComputeGameStatus();
 	bool IsGameFinished();
 };
 
+std::string GetMoveString(PackedMove move);
+std::string GetMoveString(Move move);
+
 void DebugPieceType(uint8_t type);
 void DebugPieceColor(uint8_t color);
 void DebugPiece(uint8_t piece);
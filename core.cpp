@@ -29,8 +29,9 @@ Core::Core(uint16_t _win_width, uint16_t _win_height, float _aspect_ratio)
     vp_cam.rotation = 0;
     vp_cam.zoom = 1;
 
-    engine = new UCIEngine("./stockfish.exe");
-    engine->RunCommand("uci", "uciok");
+    // ONE ENGINE FOR THE AUTOPLAY BACKGROUND AND ONE FOR THE GAME, ONLY THE GAME'S GETS EVERY CORE
+    uint32_t threads = std::thread::hardware_concurrency();
+    engine_pool = new EnginePool(2, (threads < 1) ? 1 : (threads > 255) ? 255 : threads);
 
     board = new Board;
 }
\ No newline at end of file
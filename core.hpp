@@ -1,7 +1,7 @@
 #ifndef CORE_HPP
 #define CORE_HPP
 
-#include <uci_engine.hpp>
+#include <engine_pool.hpp>
 #include <chess.hpp>
 #include <utils.hpp>
 
@@ -21,7 +21,7 @@ struct Core
     Camera2D default_cam;
     Camera2D vp_cam;
 
-    UCIEngine *engine;
+    EnginePool *engine_pool;
     Board *board;
 
     float delta_time;
@@ -0,0 +1,913 @@
+#include <engine.hpp>
+
+// PIECE SQUARE TABLES FROM WHITE'S POINT OF VIEW, INDEXED A8 FIRST LIKE THE BOARD
+// BLACK PIECES READ THEM MIRRORED (SQUARE^56)
+static const int16_t PieceSquare[6][64] = {
+	// BISHOP
+	{
+		-20,-10,-10,-10,-10,-10,-10,-20,
+		-10,  0,  0,  0,  0,  0,  0,-10,
+		-10,  0,  5, 10, 10,  5,  0,-10,
+		-10,  5,  5, 10, 10,  5,  5,-10,
+		-10,  0, 10, 10, 10, 10,  0,-10,
+		-10, 10, 10, 10, 10, 10, 10,-10,
+		-10,  5,  0,  0,  0,  0,  5,-10,
+		-20,-10,-10,-10,-10,-10,-10,-20
+	},
+	// KING, MIDDLE GAME
+	{
+		-30,-40,-40,-50,-50,-40,-40,-30,
+		-30,-40,-40,-50,-50,-40,-40,-30,
+		-30,-40,-40,-50,-50,-40,-40,-30,
+		-30,-40,-40,-50,-50,-40,-40,-30,
+		-20,-30,-30,-40,-40,-30,-30,-20,
+		-10,-20,-20,-20,-20,-20,-20,-10,
+		 20, 20,  0,  0,  0,  0, 20, 20,
+		 20, 30, 10,  0,  0, 10, 30, 20
+	},
+	// KNIGHT
+	{
+		-50,-40,-30,-30,-30,-30,-40,-50,
+		-40,-20,  0,  0,  0,  0,-20,-40,
+		-30,  0, 10, 15, 15, 10,  0,-30,
+		-30,  5, 15, 20, 20, 15,  5,-30,
+		-30,  0, 15, 20, 20, 15,  0,-30,
+		-30,  5, 10, 15, 15, 10,  5,-30,
+		-40,-20,  0,  5,  5,  0,-20,-40,
+		-50,-40,-30,-30,-30,-30,-40,-50
+	},
+	// PAWN
+	{
+		  0,  0,  0,  0,  0,  0,  0,  0,
+		 50, 50, 50, 50, 50, 50, 50, 50,
+		 10, 10, 20, 30, 30, 20, 10, 10,
+		  5,  5, 10, 25, 25, 10,  5,  5,
+		  0,  0,  0, 20, 20,  0,  0,  0,
+		  5, -5,-10,  0,  0,-10, -5,  5,
+		  5, 10, 10,-20,-20, 10, 10,  5,
+		  0,  0,  0,  0,  0,  0,  0,  0
+	},
+	// QUEEN
+	{
+		-20,-10,-10, -5, -5,-10,-10,-20,
+		-10,  0,  0,  0,  0,  0,  0,-10,
+		-10,  0,  5,  5,  5,  5,  0,-10,
+		 -5,  0,  5,  5,  5,  5,  0, -5,
+		  0,  0,  5,  5,  5,  5,  0, -5,
+		-10,  5,  5,  5,  5,  5,  0,-10,
+		-10,  0,  5,  0,  0,  0,  0,-10,
+		-20,-10,-10, -5, -5,-10,-10,-20
+	},
+	// ROOK
+	{
+		  0,  0,  0,  0,  0,  0,  0,  0,
+		  5, 10, 10, 10, 10, 10, 10,  5,
+		 -5,  0,  0,  0,  0,  0,  0, -5,
+		 -5,  0,  0,  0,  0,  0,  0, -5,
+		 -5,  0,  0,  0,  0,  0,  0, -5,
+		 -5,  0,  0,  0,  0,  0,  0, -5,
+		 -5,  0,  0,  0,  0,  0,  0, -5,
+		  0,  0,  0,  5,  5,  0,  0,  0
+	}
+};
+
+// THE KING WALKS TO THE CENTRE ONCE THE HEAVY PIECES ARE GONE
+static const int16_t KingEndgame[64] = {
+	-50,-40,-30,-20,-20,-30,-40,-50,
+	-30,-20,-10,  0,  0,-10,-20,-30,
+	-30,-10, 20, 30, 30, 20,-10,-30,
+	-30,-10, 30, 40, 40, 30,-10,-30,
+	-30,-10, 30, 40, 40, 30,-10,-30,
+	-30,-10, 20, 30, 30, 20,-10,-30,
+	-30,-30,  0,  0,  0,  0,-30,-30,
+	-50,-30,-30,-30,-30,-30,-30,-50
+};
+
+// GAME PHASE WEIGHT OF EACH PIECE, 24 WITH ALL MINOR AND MAJOR PIECES ON THE BOARD
+static const int32_t PhaseWeight[13] = {0, 2, 1, 1, 4, 0, 0, 2, 1, 1, 4, 0, 0};
+
+// SEARCH LIMITS AND EVALUATION NOISE PER LEVEL, LOWER LEVELS SEE LESS AND MISJUDGE MORE
+struct LevelSetting
+{
+	uint8_t _depth;
+	uint32_t _move_time;
+	int32_t _noise;
+};
+
+static const LevelSetting Levels[LEVEL_MAX] = {
+	{1, 50, 150},
+	{2, 100, 100},
+	{3, 200, 60},
+	{4, 300, 35},
+	{6, 500, 15},
+	{8, 800, 0},
+	{12, 1200, 0},
+	{MAX_PLY-1, 2000, 0}
+};
+
+// MATE SCORES ARE STORED RELATIVE TO THE NODE, NOT THE ROOT, SO THEY STAY TRUE WHEN THE POSITION IS REACHED AT ANOTHER PLY
+static int32_t ScoreToTT(int32_t score, uint8_t ply)
+{
+	if(score >= SCORE_MATE_BOUND) return score + ply;
+	if(score <= -SCORE_MATE_BOUND) return score - ply;
+	return score;
+}
+
+static int32_t ScoreFromTT(int32_t score, uint8_t ply)
+{
+	if(score >= SCORE_MATE_BOUND) return score - ply;
+	if(score <= -SCORE_MATE_BOUND) return score + ply;
+	return score;
+}
+
+void SwitchState::Switch()
+{
+	bool pass = _white_has_pass;
+	_white_has_pass = _black_has_pass;
+	_black_has_pass = pass;
+	_engine_color = (_engine_color == COLOR_W) ? COLOR_B : COLOR_W;
+}
+
+uint64_t SwitchState::Key()
+{
+	if(!_enabled) return 0;
+
+	// THE SAME BOARD IS WORTH DIFFERENT THINGS WITH DIFFERENT COUNTS AND PASSES LEFT, SO THEY GO INTO THE TABLE KEY
+	uint64_t key = _remaining | (_white_has_pass << 8) | (_black_has_pass << 9) | (1 << 10);
+	key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	key = (key ^ (key >> 27)) * 0x94D049BB133111EBULL;
+	return key ^ (key >> 31);
+}
+
+int32_t MateDistance(int32_t score)
+{
+	if(score >= SCORE_MATE_BOUND) return (SCORE_MATE-score+1)/2;
+	if(score <= -SCORE_MATE_BOUND) return -(SCORE_MATE+score)/2;
+	return 0;
+}
+
+std::string GetInfoString(SearchInfo &info)
+{
+	std::string line = "info depth " + std::to_string(info._depth);
+	if(info._mate != 0) line += " score mate " + std::to_string(info._mate);
+	else line += " score cp " + std::to_string(info._score);
+	line += " nodes " + std::to_string(info._nodes);
+	line += " nps " + std::to_string(info._nps);
+	line += " hashfull " + std::to_string(info._hashfull);
+	line += " time " + std::to_string(info._time);
+	if(info._pv_length > 0)
+	{
+		line += " pv";
+		for(uint8_t i = 0; i < info._pv_length; i++)
+		{
+			line += " " + GetMoveString(info._pv[i]);
+		}
+	}
+	return line;
+}
+
+Engine::Engine()
+{
+	_tt = new TranspositionTable(TT_DEFAULT_MB);
+	_level = LEVEL_MAX;
+	_move_time = 0;
+	_stop = false;
+	_pondering = false;
+	_cancel_token = 0;
+	_job_token = 0;
+	SetThreads(1);
+	NewGame();
+}
+
+Engine::~Engine()
+{
+	SetThreads(0);
+	delete _tt;
+}
+
+void Engine::SetThreads(uint8_t count)
+{
+	while(_threads.size() > count)
+	{
+		delete _threads.back();
+		_threads.pop_back();
+	}
+	while(_threads.size() < count)
+	{
+		_threads.push_back(new SearchThread(this, _threads.size()));
+	}
+}
+
+void Engine::SetHash(uint32_t mb)
+{
+	if(mb != _tt->_size_mb) _tt->Resize(mb);
+}
+
+void Engine::SetLevel(uint8_t level)
+{
+	if(level < LEVEL_MIN) level = LEVEL_MIN;
+	if(level > LEVEL_MAX) level = LEVEL_MAX;
+	_level = level;
+}
+
+// BATCH PLAY RUNS THE LEVELS ON A SHORTER CLOCK, THE DEPTH CAP AND NOISE STAY THOSE OF THE LEVEL
+void Engine::SetMoveTime(uint32_t ms)
+{
+	_move_time = ms;
+}
+
+void Engine::NewGame(uint64_t noise_seed)
+{
+	_board.Reset();
+	_switch = SwitchState();
+	_ponder_move = MOVE_NONE;
+	_tt->Clear();
+	for(SearchThread *thread : _threads)
+	{
+		thread->ClearHistory();
+	}
+	// THE NOISE DEPENDS ON THE POSITION AND THIS SEED, SO THE SAME GAME IS NOT PLAYED TWICE UNLESS ASKED TO
+	if(noise_seed == 0) noise_seed = std::chrono::steady_clock::now().time_since_epoch().count();
+	_noise_seed = noise_seed | 1;
+}
+
+void Engine::SetPosition(std::string fen)
+{
+	_board.SetPositionFromFENString(fen);
+}
+
+void Engine::SetPosition(Board &board)
+{
+	// A COPY KEEPS THE HASH HISTORY, SO THE SEARCH CAN SEE REPETITIONS A FEN WOULD HIDE
+	_board = board;
+}
+
+// EXTENDS THE ROOT BY MOVES PLAYED SINCE THE LAST SetPosition, KEEPING THE HISTORY IT ALREADY HAS
+void Engine::PlayMoves(std::vector<PackedMove> &moves)
+{
+	for(PackedMove move : moves)
+	{
+		_board.MakeMove(move);
+	}
+}
+
+void Engine::SetSwitchState(SwitchState state)
+{
+	_switch = state;
+}
+
+void Engine::Stop()
+{
+	_pondering = false;
+	_stop = true;
+}
+
+// PLAYS THE REPLY THE LAST SEARCH EXPECTED ON THE ROOT, OR RETURNS MOVE_NONE WHEN THERE IS NOTHING WORTH
+// PONDERING: NO EXPECTED MOVE, ONE THAT IS NOT LEGAL HERE, OR A CARD DRAW RIGHT AFTER IT
+PackedMove Engine::PlayPonderMove()
+{
+	PackedMove move = _ponder_move;
+	_ponder_move = MOVE_NONE;
+	if(move == MOVE_NONE) return MOVE_NONE;
+
+	MoveList moves;
+	_board.GetAllLegalMoves(_board._current_color, moves);
+	bool legal = false;
+	for(uint16_t i = 0; i < moves.Size(); i++)
+	{
+		if(moves[i] == move) legal = true;
+	}
+	if(!legal) return MOVE_NONE;
+
+	if(_switch._enabled && _board._current_color == COLOR_B)
+	{
+		if(_switch._remaining <= 1) return MOVE_NONE;
+		_switch._remaining--;
+	}
+	_board.MakeMove(move);
+	return move;
+}
+
+// THE OPPONENT PLAYED THE EXPECTED MOVE: THE PONDER SEARCH GOES ON AS A NORMAL ONE. ITS CLOCK STARTED WITH
+// THE PONDER, SO A LONG THINK BY THE OPPONENT IS ANSWERED AT ONCE FROM THE DEEPER TREE
+void Engine::PonderHit()
+{
+	_pondering = false;
+}
+
+SearchLimits Engine::GetLevelLimits()
+{
+	SearchLimits limits;
+	limits._depth = Levels[_level-1]._depth;
+	limits._move_time = _move_time ? _move_time : Levels[_level-1]._move_time;
+	return limits;
+}
+
+std::string Engine::GetBestMove()
+{
+	SearchResult result = Search(GetLevelLimits());
+	_ponder_move = (result._pv_length > 1) ? result._pv[1] : MOVE_NONE;
+	if(result._best_move == MOVE_NONE) return "";
+	return GetMoveString(result._best_move);
+}
+
+int32_t Engine::GetMate()
+{
+	return MateDistance(Search(GetLevelLimits())._score);
+}
+
+// SEARCHES THE ROOT UNDER ONE CARD OUTCOME AND RETURNS THE SCORE FROM THE ENGINE'S SIDE
+int32_t Engine::ScoreForEngine(SwitchState state, SearchLimits limits)
+{
+	SwitchState saved = _switch;
+	_switch = state;
+	SearchResult result = Search(limits);
+	_switch = saved;
+	return (state._engine_color == _board._current_color) ? result._score : -result._score;
+}
+
+// CALLED WHEN THE SWITCH CARD HAS JUST BEEN DRAWN AND THE ENGINE STILL HOLDS ITS PASS. _switch IS THE STATE
+// BEFORE THE CARD. EVERY OUTCOME IS A SHORT SEARCH ON THE SAME TABLE, SO LATER ONES REUSE THE EARLIER TREES.
+// THE PLAYER DECIDES AT THE SAME TIME, SO EACH CHOICE IS JUDGED BY THE PLAYER'S BEST ANSWER TO IT
+PassDecision Engine::DecidePass()
+{
+	PassDecision decision;
+
+	SwitchState state = _switch;
+	state._enabled = true;
+	state._remaining = SWITCH_ROUND_MOVES;
+	bool engine_white = (state._engine_color == COLOR_W);
+	bool player_has_pass = engine_white ? state._black_has_pass : state._white_has_pass;
+
+	SwitchState engine_used = state;
+	if(engine_white) engine_used._white_has_pass = false;
+	else engine_used._black_has_pass = false;
+
+	SwitchState player_used = state;
+	if(engine_white) player_used._black_has_pass = false;
+	else player_used._white_has_pass = false;
+
+	SwitchState both_used = engine_used;
+	both_used._white_has_pass = false;
+	both_used._black_has_pass = false;
+
+	SwitchState switched = state;
+	switched.Switch();
+
+	// THE WHOLE DECISION GETS HALF OF ONE MOVE'S TIME
+	SearchLimits limits = GetLevelLimits();
+	limits._move_time /= player_has_pass ? 8 : 4;
+	if(limits._move_time == 0) limits._move_time = 1;	// 0 WOULD MEAN NO LIMIT
+
+	decision._stay_score = ScoreForEngine(engine_used, limits);
+	decision._switch_score = ScoreForEngine(switched, limits);
+	if(player_has_pass)
+	{
+		int32_t both_stay = ScoreForEngine(both_used, limits);
+		int32_t player_stay = ScoreForEngine(player_used, limits);
+		if(both_stay < decision._stay_score) decision._stay_score = both_stay;
+		if(player_stay < decision._switch_score) decision._switch_score = player_stay;
+	}
+
+	decision._use_pass = (decision._stay_score > decision._switch_score);
+	return decision;
+}
+
+uint32_t Engine::Elapsed()
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now()-_start).count();
+}
+
+uint64_t Engine::GetNodes()
+{
+	uint64_t nodes = 0;
+	for(SearchThread *thread : _threads)
+	{
+		nodes += thread->_nodes.load(std::memory_order_relaxed);
+	}
+	return nodes;
+}
+
+void Engine::ReportInfo(SearchResult &result)
+{
+	if(!_on_info) return;
+
+	SearchInfo info;
+	info._depth = result._depth;
+	info._nodes = GetNodes();
+	info._time = Elapsed();
+	info._nps = info._nodes*1000 / (info._time ? info._time : 1);
+	info._score = result._score;
+	info._mate = MateDistance(result._score);
+	info._hashfull = _tt->HashFull();
+	info._pv_length = result._pv_length;
+	for(uint8_t i = 0; i < result._pv_length; i++)
+	{
+		info._pv[i] = result._pv[i];
+	}
+	_on_info(info);
+}
+
+bool Engine::TimeUp()
+{
+	if(_limits._nodes && GetNodes() >= _limits._nodes) return true;
+	if(_limits._move_time && !_pondering && Elapsed() >= _limits._move_time) return true;
+	return false;
+}
+
+SearchResult Engine::Search(SearchLimits limits)
+{
+	SearchResult result;
+
+	_limits = limits;
+	_start = std::chrono::steady_clock::now();
+	// CLEARED FIRST, SO A Cancel COMING IN BETWEEN EITHER SHOWS IN THE TOKEN OR SETS _stop AFTER THIS
+	_stop = false;
+	if(_cancel_token != _job_token) _stop = true;
+	_tt->NewSearch();
+
+	if(_limits._depth < 1) _limits._depth = 1;
+	if(_limits._depth > MAX_PLY-1) _limits._depth = MAX_PLY-1;
+
+	MoveList roots;
+	_board.GetAllLegalMoves(_board._current_color, roots);
+	if(roots.Size() == 0)
+	{
+		result._score = _board.IsInCheck(_board._current_color) ? -SCORE_MATE : 0;
+		return result;
+	}
+
+	// LAZY SMP: EVERY THREAD SEARCHES THE SAME ROOT ON ITS OWN BOARD, AND THEY ONLY TALK THROUGH THE TABLE
+	std::vector<std::thread> helpers;
+	for(uint8_t i = 1; i < _threads.size(); i++)
+	{
+		helpers.push_back(std::thread(&SearchThread::Run, _threads[i]));
+	}
+	_threads[0]->Run();
+	_stop = true;
+	for(std::thread &helper : helpers)
+	{
+		helper.join();
+	}
+
+	// THE DEEPEST COMPLETED ITERATION WINS, THE MAIN THREAD ON A TIE
+	result = _threads[0]->_result;
+	for(uint8_t i = 1; i < _threads.size(); i++)
+	{
+		SearchResult &other = _threads[i]->_result;
+		if(other._depth > result._depth && other._best_move != MOVE_NONE) result = other;
+	}
+	// A FALLBACK SO A SEARCH STOPPED INSIDE ITS FIRST ITERATION STILL ANSWERS
+	if(result._best_move == MOVE_NONE) result._best_move = roots[0];
+
+	result._nodes = GetNodes();
+	result._time = Elapsed();
+	return result;
+}
+
+SearchThread::SearchThread(Engine *engine, uint8_t id)
+{
+	_engine = engine;
+	_id = id;
+	_nodes = 0;
+	_root_best = MOVE_NONE;
+	ClearHistory();
+}
+
+void SearchThread::ClearHistory()
+{
+	for(uint8_t p = 0; p < 13; p++)
+	{
+		for(uint8_t s = 0; s < 64; s++)
+		{
+			_history[p][s] = 0;
+		}
+	}
+}
+
+void SearchThread::CountNode()
+{
+	// ONLY THIS THREAD WRITES ITS COUNTER, THE ENGINE READS IT FOR NODE LIMITS AND REPORTS
+	uint64_t nodes = _nodes.load(std::memory_order_relaxed) + 1;
+	_nodes.store(nodes, std::memory_order_relaxed);
+	if((nodes & 1023) == 0 && _engine->TimeUp()) _engine->_stop = true;
+}
+
+void SearchThread::Run()
+{
+	SearchLimits &limits = _engine->_limits;
+
+	_board = _engine->_board;
+	_switch = _engine->_switch;
+	_nodes = 0;
+	_root_best = MOVE_NONE;
+	_result = SearchResult();
+
+	for(uint8_t i = 0; i < MAX_PLY; i++)
+	{
+		_killers[i][0] = MOVE_NONE;
+		_killers[i][1] = MOVE_NONE;
+	}
+	for(uint8_t p = 0; p < 13; p++)
+	{
+		for(uint8_t s = 0; s < 64; s++)
+		{
+			_history[p][s] /= 8;
+		}
+	}
+
+	// EVERY OTHER HELPER STARTS ONE PLY DEEPER, SO THE THREADS SPREAD OVER NEIGHBOURING DEPTHS
+	// AND FILL THE TABLE WITH RESULTS THE OTHERS HAVE NOT REACHED YET
+	for(uint8_t depth = 1 + (_id & 1); depth <= limits._depth; depth++)
+	{
+		int32_t score = AlphaBeta(-SCORE_INF, SCORE_INF, depth, 0, false);
+
+		// A STOPPED ITERATION HAS NOT LOOKED AT EVERY ROOT MOVE, KEEP THE LAST COMPLETE ONE
+		if(_engine->_stop) break;
+
+		_result._score = score;
+		_result._depth = depth;
+		_result._pv_length = _pv_length[0];
+		for(uint8_t i = 0; i < _pv_length[0]; i++)
+		{
+			_result._pv[i] = _pv[0][i];
+		}
+		if(_pv_length[0] > 0)
+		{
+			_result._best_move = _pv[0][0];
+			_root_best = _pv[0][0];
+		}
+
+		// ONLY THE MAIN THREAD REPORTS AND DECIDES WHEN THE SEARCH IS OVER
+		if(_id != 0) continue;
+
+		_engine->ReportInfo(_result);
+
+		if(MateDistance(score) != 0) break;
+		// THE NEXT ITERATION COSTS SEVERAL TIMES THIS ONE, DO NOT START WHAT CANNOT FINISH
+		if(limits._move_time && !_engine->_pondering && _engine->Elapsed() >= limits._move_time/2) break;
+	}
+}
+
+int32_t SearchThread::Evaluate()
+{
+	int32_t score = _board.GetMaterial(COLOR_ALL);
+	int32_t phase = 0;
+	int32_t king_mg = 0;
+	int32_t king_eg = 0;
+
+	for(uint8_t p = RB; p <= PW; p++)
+	{
+		Bitboard pieces = _board._piece_bb[p];
+		bool white = IsWhite(p);
+		uint8_t type = TypeOf(p);
+		phase += PhaseWeight[p]*_board._piece_count[p];
+		while(pieces)
+		{
+			uint8_t s = PopLSB(pieces);
+			uint8_t index = white ? s : (s^56);
+			if(type == KING)
+			{
+				king_mg += white ? PieceSquare[KING][index] : -PieceSquare[KING][index];
+				king_eg += white ? KingEndgame[index] : -KingEndgame[index];
+			}
+			else score += white ? PieceSquare[type][index] : -PieceSquare[type][index];
+		}
+	}
+
+	if(phase > 24) phase = 24;
+	score += (king_mg*phase + king_eg*(24-phase))/24;
+
+	if(_board._piece_count[BW] >= 2) score += 30;
+	if(_board._piece_count[BB] >= 2) score -= 30;
+
+	if(_board._current_color == COLOR_B) score = -score;
+
+	int32_t noise = Levels[_engine->_level-1]._noise;
+	if(noise > 0)
+	{
+		uint64_t h = (_board._hash ^ _engine->_noise_seed) * 0x9E3779B97F4A7C15ULL;
+		score += (int32_t)((h >> 32) % (2*noise+1)) - noise;
+	}
+
+	return score;
+}
+
+bool SearchThread::IsCapture(PackedMove move)
+{
+	return _board._squares[MoveEnd(move)] != EMPTY || MoveType(move) == ENPASSANT;
+}
+
+bool SearchThread::IsDraw()
+{
+	if(_board._half_move_clock >= 100) return true;
+
+	// BARE KINGS, OR A SINGLE MINOR PIECE AGAINST A KING, CANNOT MATE
+	uint8_t *count = _board._piece_count;
+	if(count[PB]+count[PW]+count[RB]+count[RW]+count[QB]+count[QW] == 0 && count[NB]+count[BB] <= 1 && count[NW]+count[BW] <= 1) return true;
+
+	// ONE EARLIER OCCURRENCE IS ENOUGH, IF IT WAS GOOD ONCE IT CAN BE FORCED AGAIN
+	return _board.GetRepetitionCount() >= 2;
+}
+
+void SearchThread::ScoreMoves(MoveList &moves, int32_t *scores, PackedMove best, uint8_t ply)
+{
+	for(uint16_t i = 0; i < moves.Size(); i++)
+	{
+		PackedMove move = moves[i];
+		uint8_t piece = _board._squares[MoveStart(move)];
+		if(move == best) scores[i] = 1 << 30;
+		else if(IsCapture(move))
+		{
+			// MOST VALUABLE VICTIM FIRST, CHEAPEST ATTACKER BREAKS TIES
+			uint8_t victim = (MoveType(move) == ENPASSANT) ? PW : _board._squares[MoveEnd(move)];
+			scores[i] = (1 << 24) + PieceValue[victim]*16 - PieceValue[piece]/16;
+		}
+		else if(MoveFlags(move) == PROMOTION_Q) scores[i] = (1 << 24) + PieceValue[QW]*16;
+		else if(move == _killers[ply][0]) scores[i] = (1 << 22);
+		else if(move == _killers[ply][1]) scores[i] = (1 << 22) - 1;
+		else scores[i] = _history[piece][MoveEnd(move)];
+	}
+}
+
+// SELECTION SORT ONE STEP AT A TIME, A CUTOFF USUALLY COMES BEFORE THE LIST IS SORTED
+static PackedMove PickMove(MoveList &moves, int32_t *scores, uint16_t i)
+{
+	uint16_t best = i;
+	for(uint16_t j = i+1; j < moves.Size(); j++)
+	{
+		if(scores[j] > scores[best]) best = j;
+	}
+	PackedMove move = moves[best];
+	int32_t score = scores[best];
+	moves[best] = moves[i];
+	scores[best] = scores[i];
+	moves[i] = move;
+	scores[i] = score;
+	return move;
+}
+
+int32_t SearchThread::AlphaBeta(int32_t alpha, int32_t beta, int32_t depth, uint8_t ply, bool null_allowed)
+{
+	_pv_length[ply] = ply;
+
+	if(depth <= 0) return Quiescence(alpha, beta, ply);
+
+	CountNode();
+	if(_engine->_stop) return 0;
+
+	if(ply > 0)
+	{
+		if(IsDraw()) return 0;
+
+		// NO LINE FROM HERE CAN BEAT A MATE ALREADY FOUND CLOSER TO THE ROOT
+		if(alpha < -SCORE_MATE+ply) alpha = -SCORE_MATE+ply;
+		if(beta > SCORE_MATE-ply-1) beta = SCORE_MATE-ply-1;
+		if(alpha >= beta) return alpha;
+	}
+	if(ply >= MAX_PLY-1) return Evaluate();
+
+	// A CARD DRAW AT THE ROOT IS THE CALLER'S TO RESOLVE, THE SEARCH ONLY LOOKS AHEAD TO THE NEXT ONES
+	if(_switch._enabled && _switch._remaining == 0 && ply > 0) return CardNode(depth, ply);
+
+	uint8_t color = _board._current_color;
+	bool in_check = _board.IsInCheck(color);
+	if(in_check) depth++;
+
+	bool pv_node = (beta-alpha > 1);
+	int32_t alpha_start = alpha;
+
+	uint64_t key = _board._hash ^ _switch.Key();
+	TTData tt;
+	PackedMove tt_move = MOVE_NONE;
+	if(_engine->_tt->Probe(key, tt))
+	{
+		tt_move = tt._move;
+		int32_t tt_score = ScoreFromTT(tt._score, ply);
+		if(!pv_node && ply > 0 && tt._depth >= depth)
+		{
+			if(tt._bound == BOUND_EXACT) return tt_score;
+			if(tt._bound == BOUND_LOWER && tt_score >= beta) return tt_score;
+			if(tt._bound == BOUND_UPPER && tt_score <= alpha) return tt_score;
+		}
+	}
+
+	// GIVING THE OPPONENT A FREE MOVE AND STILL FAILING HIGH MEANS THIS NODE IS NOT WORTH A FULL SEARCH
+	// SKIPPED WITHOUT PIECES, WHERE ZUGZWANG MAKES PASSING BETTER THAN ANY MOVE
+	Bitboard pieces = _board._color_bb[color] & ~(_board._piece_bb[PB] | _board._piece_bb[PW] | _board._piece_bb[KB] | _board._piece_bb[KW]);
+	if(null_allowed && !pv_node && !in_check && depth >= 3 && pieces && Evaluate() >= beta)
+	{
+		int32_t reduction = 2 + depth/6;
+		_board.MakeNullMove();
+		int32_t score = -AlphaBeta(-beta, -beta+1, depth-1-reduction, ply+1, false);
+		_board.UnMakeNullMove();
+		if(_engine->_stop) return 0;
+		if(score >= beta) return (score >= SCORE_MATE_BOUND) ? beta : score;
+	}
+
+	MoveList moves;
+	_board.GetAllLegalMoves(color, moves);
+	if(moves.Size() == 0) return in_check ? -SCORE_MATE+ply : 0;
+
+	int32_t scores[MAX_MOVES];
+	ScoreMoves(moves, scores, (ply == 0 && _root_best != MOVE_NONE) ? _root_best : tt_move, ply);
+
+	int32_t best_score = -SCORE_INF;
+	PackedMove best_move = MOVE_NONE;
+	for(uint16_t i = 0; i < moves.Size(); i++)
+	{
+		PackedMove move = PickMove(moves, scores, i);
+		bool quiet = !IsCapture(move) && MoveType(move) != PROMOTION;
+		uint8_t piece = _board._squares[MoveStart(move)];
+
+		// BLACK'S MOVE COMPLETES A FULL MOVE
+		bool counted = (_switch._enabled && color == COLOR_B && _switch._remaining > 0);
+		if(counted) _switch._remaining--;
+
+		_board.MakeMove(move);
+		int32_t score;
+		if(i == 0) score = -AlphaBeta(-beta, -alpha, depth-1, ply+1, true);
+		else
+		{
+			// LATE QUIET MOVES ARE SEARCHED SHALLOWER, AND AGAIN AT FULL DEPTH ONLY IF THEY SURPRISE
+			int32_t reduction = 0;
+			if(depth >= 3 && i >= 3 && quiet && !in_check && !_board.IsInCheck(_board._current_color))
+			{
+				reduction = (i >= 8) ? 2 : 1;
+			}
+			score = -AlphaBeta(-alpha-1, -alpha, depth-1-reduction, ply+1, true);
+			if(score > alpha && reduction > 0) score = -AlphaBeta(-alpha-1, -alpha, depth-1, ply+1, true);
+			if(score > alpha && score < beta) score = -AlphaBeta(-beta, -alpha, depth-1, ply+1, true);
+		}
+		_board.UnMakeMove();
+
+		if(counted) _switch._remaining++;
+
+		if(_engine->_stop) return 0;
+
+		if(score > best_score)
+		{
+			best_score = score;
+			best_move = move;
+			if(score > alpha)
+			{
+				alpha = score;
+
+				_pv[ply][ply] = move;
+				for(uint8_t j = ply+1; j < _pv_length[ply+1]; j++)
+				{
+					_pv[ply][j] = _pv[ply+1][j];
+				}
+				_pv_length[ply] = (_pv_length[ply+1] > ply+1) ? _pv_length[ply+1] : ply+1;
+
+				if(score >= beta)
+				{
+					if(quiet)
+					{
+						if(_killers[ply][0] != move)
+						{
+							_killers[ply][1] = _killers[ply][0];
+							_killers[ply][0] = move;
+						}
+						_history[piece][MoveEnd(move)] += depth*depth;
+						if(_history[piece][MoveEnd(move)] > (1 << 20)) _history[piece][MoveEnd(move)] /= 2;
+					}
+					break;
+				}
+			}
+		}
+	}
+
+	uint8_t bound = BOUND_EXACT;
+	if(best_score >= beta) bound = BOUND_LOWER;
+	else if(best_score <= alpha_start) bound = BOUND_UPPER;
+	// A NODE THAT FAILED LOW HAS NO BEST MOVE WORTH REMEMBERING
+	if(bound == BOUND_UPPER) best_move = MOVE_NONE;
+	_engine->_tt->Store(key, best_move, ScoreToTT(best_score, ply), (depth > 255) ? 255 : depth, bound);
+
+	return best_score;
+}
+
+// CHANCE NODE FOR THE CARD DRAW, BOTH CARDS ARE EQUALLY LIKELY. SCORES ARE FOR THE PLAYER HOLDING WHITE, WHO IS TO MOVE
+int32_t SearchThread::CardNode(int32_t depth, uint8_t ply)
+{
+	MoveList moves;
+	_board.GetAllLegalMoves(_board._current_color, moves);
+	if(moves.Size() == 0) return _board.IsInCheck(_board._current_color) ? -SCORE_MATE+ply : 0;
+
+	SwitchState plus5 = _switch;
+	plus5._remaining = PLUS5_MOVES;
+	int32_t plus5_score = SearchCardBranch(plus5, depth, ply, false);
+	if(_engine->_stop) return 0;
+
+	int32_t switch_score = SwitchCardValue(depth, ply);
+	if(_engine->_stop) return 0;
+
+	return (plus5_score + switch_score)/2;
+}
+
+// BOTH PLAYERS DECIDE ON THEIR PASS AT ONCE, SO THE HOLDER OF WHITE TAKES THE BETTER OF ITS TWO CHOICES
+// ASSUMING THE WORST ANSWER TO EACH. ANY USED PASS CANCELS THE SWITCH
+int32_t SearchThread::SwitchCardValue(int32_t depth, uint8_t ply)
+{
+	SwitchState state = _switch;
+	state._remaining = SWITCH_ROUND_MOVES;
+
+	SwitchState switched = state;
+	switched.Switch();
+	int32_t switch_score = SearchCardBranch(switched, depth, ply, true);
+	if(_engine->_stop || (!state._white_has_pass && !state._black_has_pass)) return switch_score;
+
+	SwitchState white_used = state;
+	white_used._white_has_pass = false;
+	SwitchState black_used = state;
+	black_used._black_has_pass = false;
+
+	if(!state._black_has_pass)
+	{
+		int32_t stay = SearchCardBranch(white_used, depth, ply, false);
+		return (stay > switch_score) ? stay : switch_score;
+	}
+	if(!state._white_has_pass)
+	{
+		int32_t stay = SearchCardBranch(black_used, depth, ply, false);
+		return (stay < switch_score) ? stay : switch_score;
+	}
+
+	SwitchState both_used = white_used;
+	both_used._black_has_pass = false;
+	int32_t white_stay = SearchCardBranch(white_used, depth, ply, false);
+	int32_t black_stay = SearchCardBranch(black_used, depth, ply, false);
+	int32_t both_stay = SearchCardBranch(both_used, depth, ply, false);
+
+	int32_t use = (both_stay < white_stay) ? both_stay : white_stay;
+	int32_t keep = (black_stay < switch_score) ? black_stay : switch_score;
+	return (use > keep) ? use : keep;
+}
+
+// SEARCHES THE SAME BOARD UNDER ANOTHER VARIANT STATE. AFTER A SWITCH THE SIDE TO MOVE BELONGS
+// TO THE OTHER PLAYER, SO ITS SCORE IS NEGATED BACK TO THE PLAYER THAT HELD WHITE BEFORE THE CARD
+int32_t SearchThread::SearchCardBranch(SwitchState state, int32_t depth, uint8_t ply, bool switched)
+{
+	SwitchState saved = _switch;
+	_switch = state;
+	int32_t score = AlphaBeta(-SCORE_INF, SCORE_INF, depth, ply, false);
+	_switch = saved;
+	return switched ? -score : score;
+}
+
+int32_t SearchThread::Quiescence(int32_t alpha, int32_t beta, uint8_t ply)
+{
+	_pv_length[ply] = ply;
+
+	CountNode();
+	if(_engine->_stop) return 0;
+
+	int32_t stand_pat = Evaluate();
+	if(ply >= MAX_PLY-1) return stand_pat;
+	if(stand_pat >= beta) return stand_pat;
+	if(stand_pat > alpha) alpha = stand_pat;
+
+	MoveList all;
+	_board.GetAllLegalMoves(_board._current_color, all);
+
+	MoveList moves;
+	for(PackedMove move : all)
+	{
+		if(IsCapture(move) || MoveFlags(move) == PROMOTION_Q) moves.Add(move);
+	}
+
+	int32_t scores[MAX_MOVES];
+	ScoreMoves(moves, scores, MOVE_NONE, ply);
+
+	int32_t best_score = stand_pat;
+	for(uint16_t i = 0; i < moves.Size(); i++)
+	{
+		PackedMove move = PickMove(moves, scores, i);
+
+		// A CAPTURE THAT CANNOT LIFT THE SCORE TO ALPHA EVEN UNANSWERED IS NOT WORTH PLAYING OUT
+		if(MoveType(move) != PROMOTION)
+		{
+			uint8_t victim = (MoveType(move) == ENPASSANT) ? PW : _board._squares[MoveEnd(move)];
+			if(stand_pat + PieceValue[victim] + 200 < alpha) continue;
+		}
+
+		_board.MakeMove(move);
+		int32_t score = -Quiescence(-beta, -alpha, ply+1);
+		_board.UnMakeMove();
+
+		if(_engine->_stop) return 0;
+
+		if(score > best_score)
+		{
+			best_score = score;
+			if(score > alpha)
+			{
+				alpha = score;
+				if(score >= beta) break;
+			}
+		}
+	}
+
+	return best_score;
+}
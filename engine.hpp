@@ -0,0 +1,178 @@
+#ifndef ENGINE_HPP
+#define ENGINE_HPP
+
+#include <chess.hpp>
+#include <transposition_table.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+// SEARCH BOUNDS
+#define MAX_PLY 64
+
+// SCORES ARE CENTIPAWNS FOR THE SIDE TO MOVE, A MATE IN n PLIES SCORES SCORE_MATE-n
+#define SCORE_INF 32000
+#define SCORE_MATE 31000
+#define SCORE_MATE_BOUND (SCORE_MATE-MAX_PLY)
+
+// STRENGTH LEVELS, SAME RANGE THE OPPONENT CARDS USE
+#define LEVEL_MIN 1
+#define LEVEL_MAX 8
+
+struct SearchLimits
+{
+	uint8_t _depth = MAX_PLY-1;
+	uint32_t _move_time = 0;	// MILLISECONDS, 0 FOR NO LIMIT
+	uint64_t _nodes = 0;		// 0 FOR NO LIMIT
+};
+
+// SWITCH CHESS RULES: A CARD IS DRAWN EVERY TIME THE FULL MOVE COUNT RUNS OUT. PLUS 5 ADDS FIVE MOVES,
+// SWITCH MAKES THE PLAYERS TRADE COLOURS UNLESS ONE OF THEM USES THEIR ONE PASS, AND ADDS TEN MOVES
+#define SWITCH_ROUND_MOVES 10
+#define PLUS5_MOVES 5
+
+// VARIANT STATE CARRIED BY THE SEARCH. PASSES ARE KEPT BY COLOUR, SO THEY MOVE WITH THE PLAYERS WHEN THEY SWITCH
+struct SwitchState
+{
+	bool _enabled = false;
+	uint8_t _remaining = SWITCH_ROUND_MOVES;	// FULL MOVES BEFORE THE NEXT CARD, COUNTED DOWN ON BLACK'S MOVES
+	bool _white_has_pass = true;
+	bool _black_has_pass = true;
+	uint8_t _engine_color = COLOR_B;
+
+	void Switch();
+	uint64_t Key();
+};
+
+// OUTCOME OF A PASS DECISION, SCORES ARE FOR THE ENGINE
+struct PassDecision
+{
+	bool _use_pass = false;
+	int32_t _stay_score = 0;
+	int32_t _switch_score = 0;
+};
+
+struct SearchResult
+{
+	PackedMove _best_move = MOVE_NONE;
+	int32_t _score = 0;
+	uint8_t _depth = 0;
+	uint64_t _nodes = 0;
+	uint32_t _time = 0;			// MILLISECONDS
+	PackedMove _pv[MAX_PLY];
+	uint8_t _pv_length = 0;
+};
+
+// PROGRESS OF A RUNNING SEARCH, PUBLISHED AFTER EVERY ITERATION THE MAIN THREAD COMPLETES
+struct SearchInfo
+{
+	uint8_t _depth = 0;
+	uint64_t _nodes = 0;
+	uint64_t _nps = 0;
+	uint32_t _time = 0;			// MILLISECONDS
+	int32_t _score = 0;			// CENTIPAWNS FOR THE SIDE TO MOVE
+	int32_t _mate = 0;			// SAME AS MateDistance, 0 WHEN THE SCORE IS NOT A MATE
+	uint16_t _hashfull = 0;		// PERMILLE
+	PackedMove _pv[MAX_PLY];
+	uint8_t _pv_length = 0;
+};
+
+// SAME FORMAT AS A UCI info LINE
+std::string GetInfoString(SearchInfo &info);
+
+typedef std::function<void(SearchInfo &info)> InfoCallback;
+
+// MOVES TO MATE FOR THE SIDE TO MOVE, NEGATIVE WHEN IT IS GETTING MATED, 0 WHEN THE SCORE IS NOT A MATE
+int32_t MateDistance(int32_t score);
+
+struct Engine;
+
+// ONE SEARCHER WITH ITS OWN BOARD AND MOVE ORDERING STATE, THE ENGINE RUNS ONE PER THREAD
+struct SearchThread
+{
+	Engine *_engine;
+	uint8_t _id;	// 0 IS THE MAIN THREAD
+	Board _board;
+	std::atomic<uint64_t> _nodes;
+	SearchResult _result;	// LAST COMPLETED ITERATION
+	SwitchState _switch;
+
+	PackedMove _pv[MAX_PLY][MAX_PLY];
+	uint8_t _pv_length[MAX_PLY];
+	PackedMove _killers[MAX_PLY][2];
+	int32_t _history[13][64];	// [PIECE][END SQUARE]
+	PackedMove _root_best;
+
+	SearchThread(Engine *engine, uint8_t id);
+	void ClearHistory();
+	void CountNode();
+	void Run();
+
+	int32_t Evaluate();
+	int32_t AlphaBeta(int32_t alpha, int32_t beta, int32_t depth, uint8_t ply, bool null_allowed);
+	int32_t Quiescence(int32_t alpha, int32_t beta, uint8_t ply);
+	int32_t CardNode(int32_t depth, uint8_t ply);
+	int32_t SwitchCardValue(int32_t depth, uint8_t ply);
+	int32_t SearchCardBranch(SwitchState state, int32_t depth, uint8_t ply, bool switched);
+	void ScoreMoves(MoveList &moves, int32_t *scores, PackedMove best, uint8_t ply);
+	bool IsCapture(PackedMove move);
+	bool IsDraw();
+};
+
+// IN PROCESS ALPHA-BETA SEARCH: ITERATIVE DEEPENING, PVS, NULL MOVE, LATE MOVE REDUCTIONS AND QUIESCENCE
+// WITH MORE THAN ONE THREAD THE HELPERS SEARCH THE SAME ROOT AND SHARE THE TRANSPOSITION TABLE (LAZY SMP)
+struct Engine
+{
+	Board _board;	// ROOT POSITION
+	TranspositionTable *_tt;
+	std::vector<SearchThread*> _threads;
+	uint8_t _level;
+	uint32_t _move_time;	// OVERRIDES THE LEVEL'S TIME WHEN NOT 0
+	uint64_t _noise_seed;
+	SwitchState _switch;	// ROOT VARIANT STATE, DISABLED FOR PLAIN CHESS
+
+	std::atomic<bool> _stop;
+	std::atomic<bool> _pondering;	// THE CLOCK DOES NOT RUN UNTIL PonderHit
+	// A CANCELLED REQUEST MAY STILL START SEARCHES, THE ONE IT HAD NOT BEGUN OR THE LATER ONES OF DecidePass.
+	// THE CALLER BUMPS _cancel_token TO CANCEL, AND EVERY SEARCH OF A REQUEST WITH A STALE _job_token STOPS AT ONCE
+	std::atomic<uint32_t> _cancel_token;
+	uint32_t _job_token;
+	SearchLimits _limits;
+	std::chrono::steady_clock::time_point _start;
+	PackedMove _ponder_move;	// REPLY EXPECTED AFTER THE LAST BEST MOVE
+	InfoCallback _on_info;		// CALLED ON THE SEARCHING THREAD, MUST BE QUICK
+
+	Engine();
+	~Engine();
+	void SetLevel(uint8_t level);
+	void SetMoveTime(uint32_t ms);
+	void SetHash(uint32_t mb);
+	void SetThreads(uint8_t count);
+	void NewGame(uint64_t noise_seed = 0);	// 0 SEEDS THE NOISE FROM THE CLOCK
+	void SetPosition(std::string fen);
+	void SetPosition(Board &board);
+	void PlayMoves(std::vector<PackedMove> &moves);
+	void SetSwitchState(SwitchState state);
+
+	SearchLimits GetLevelLimits();
+	SearchResult Search(SearchLimits limits);
+	std::string GetBestMove();
+	int32_t GetMate();
+	PassDecision DecidePass();
+	int32_t ScoreForEngine(SwitchState state, SearchLimits limits);
+	PackedMove PlayPonderMove();
+	void PonderHit();
+	void Stop();
+
+	uint64_t GetNodes();
+	void ReportInfo(SearchResult &result);
+	bool TimeUp();
+	uint32_t Elapsed();
+};
+
+#endif
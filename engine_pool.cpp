@@ -0,0 +1,62 @@
+#include <engine_pool.hpp>
+
+EnginePool::EnginePool(uint8_t warm, uint8_t max_threads)
+{
+	_max_threads = (max_threads < 1) ? 1 : max_threads;
+
+	// WARM ENGINES HAVE THEIR TABLES ALLOCATED AND THREADS RUNNING BEFORE THE FIRST GAME ASKS FOR ONE
+	for(uint8_t i = 0; i < warm; i++)
+	{
+		_idle.push_back(Create());
+	}
+}
+
+EnginePool::~EnginePool()
+{
+	for(EngineWorker *worker : _all)
+	{
+		Engine *engine = worker->_engine;
+		delete worker;
+		delete engine;
+	}
+}
+
+EngineWorker *EnginePool::Create()
+{
+	Engine *engine = new Engine;
+	EngineWorker *worker = new EngineWorker(engine);
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	_all.push_back(worker);
+	return worker;
+}
+
+EngineWorker *EnginePool::Acquire(uint8_t level, uint8_t threads, uint32_t hash_mb)
+{
+	if(threads < 1) threads = 1;
+	if(threads > _max_threads) threads = _max_threads;
+
+	EngineWorker *worker = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if(!_idle.empty())
+		{
+			worker = _idle.back();
+			_idle.pop_back();
+		}
+	}
+	if(worker == nullptr) worker = Create();
+
+	worker->Configure(level, hash_mb, threads);
+	return worker;
+}
+
+void EnginePool::Release(EngineWorker *worker)
+{
+	if(worker == nullptr) return;
+
+	worker->Cancel();
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	_idle.push_back(worker);
+}
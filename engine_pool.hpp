@@ -0,0 +1,28 @@
+#ifndef ENGINE_POOL_HPP
+#define ENGINE_POOL_HPP
+
+#include <engine.hpp>
+#include <engine_worker.hpp>
+
+#include <mutex>
+#include <vector>
+
+// HANDS OUT ENGINES ON LEASE, EACH WITH ITS OWN WORKER THREAD, TABLE AND LEVEL, SO CONCURRENT GAMES
+// NEVER RESET EACH OTHER. RELEASED ENGINES ARE KEPT AND RECYCLED FOR THE NEXT LEASE. EVERY LEASE NAMES ITS
+// OWN SEARCH THREAD COUNT, SO ONLY THE ENGINE THAT MATTERS TAKES THE WHOLE MACHINE
+struct EnginePool
+{
+	std::mutex _mutex;
+	std::vector<EngineWorker*> _all;
+	std::vector<EngineWorker*> _idle;
+	uint8_t _max_threads;	// THE MOST SEARCH THREADS ONE LEASE CAN HAVE
+
+	EnginePool(uint8_t warm, uint8_t max_threads);
+	~EnginePool();
+
+	EngineWorker *Create();
+	EngineWorker *Acquire(uint8_t level, uint8_t threads = 1, uint32_t hash_mb = TT_DEFAULT_MB);
+	void Release(EngineWorker *worker);
+};
+
+#endif
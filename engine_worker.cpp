@@ -0,0 +1,267 @@
+#include <engine_worker.hpp>
+
+EngineWorker::EngineWorker(Engine *engine)
+{
+	_engine = engine;
+	_quit = false;
+	_sent_valid = false;
+	_sent_ply = 0;
+	_sent_hash = 0;
+	_ponder_queued = false;
+	_ponder_ply = 0;
+	_ponder_hash = 0;
+	_ponder_move = MOVE_NONE;
+	_engine->_on_info = [this](SearchInfo &info)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_infos.push_back(info);
+		if(_infos.size() > INFO_QUEUE_SIZE) _infos.pop_front();
+	};
+	_thread = std::thread(&EngineWorker::Loop, this);
+}
+
+EngineWorker::~EngineWorker()
+{
+	Cancel();
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_quit = true;
+	}
+	_wake.notify_one();
+	_thread.join();
+	_engine->_on_info = nullptr;
+}
+
+// THE JOB CARRIES THE CANCEL TOKEN IT WAS QUEUED UNDER, SO A Cancel STILL REACHES IT ONCE IT HAS LEFT THE QUEUE
+void EngineWorker::Push(EngineJob job)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		uint32_t token = _engine->_cancel_token;
+		_jobs.push_back([job, token](Engine *engine, bool cancelled)
+		{
+			engine->_job_token = token;
+			job(engine, cancelled);
+		});
+	}
+	_wake.notify_one();
+}
+
+void EngineWorker::Cancel()
+{
+	std::deque<EngineJob> dropped;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		dropped.swap(_jobs);
+		// THE DROPPED JOBS NEVER MOVE THE ROOT, SO THE NEXT REQUEST SENDS THE FULL BOARD
+		_sent_valid = false;
+		_ponder_queued = false;
+		_ponder_move = MOVE_NONE;
+		_infos.clear();
+		_engine->_cancel_token++;
+	}
+	for(EngineJob &job : dropped)
+	{
+		job(_engine, true);
+	}
+	_engine->Stop();
+}
+
+// TAKES THE OLDEST REPORT NOT READ YET, FALSE WHEN THERE IS NONE. REPORTS FROM EVERY REQUEST SHARE THE QUEUE
+bool EngineWorker::PollInfo(SearchInfo &info)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if(_infos.empty()) return false;
+	info = _infos.front();
+	_infos.pop_front();
+	return true;
+}
+
+void PositionUpdate::Apply(Engine *engine)
+{
+	if(_board) engine->SetPosition(*_board);
+	else engine->PlayMoves(_moves);
+}
+
+PositionUpdate EngineWorker::MakeUpdate(Board &board)
+{
+	PositionUpdate update;
+	uint32_t ply = board._move_history.size();
+
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	// THE NEW BOARD CONTINUES THE LAST ONE IF IT PASSED THROUGH THE SAME POSITION AT THE SAME PLY
+	bool extends = _sent_valid && ply >= _sent_ply;
+	if(extends)
+	{
+		uint64_t hash = (_sent_ply < ply) ? board._hash_history[_sent_ply] : board._hash;
+		extends = (hash == _sent_hash);
+	}
+
+	if(extends)
+	{
+		for(uint32_t i = _sent_ply; i < ply; i++)
+		{
+			update._moves.push_back(board._move_history[i]._move);
+		}
+	}
+	else update._board = std::make_shared<Board>(board);
+
+	_sent_valid = true;
+	_sent_ply = ply;
+	_sent_hash = board._hash;
+	return update;
+}
+
+void EngineWorker::Loop()
+{
+	while(true)
+	{
+		EngineJob job;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_wake.wait(lock, [this]{ return _quit || !_jobs.empty(); });
+			if(_jobs.empty()) return;
+			job = _jobs.front();
+			_jobs.pop_front();
+		}
+		job(_engine, false);
+	}
+}
+
+// WRAPS A REQUEST INTO A JOB THAT FULFILS A PROMISE, A DROPPED JOB ANSWERS WITH fallback
+template<typename T>
+static std::future<T> PushRequest(EngineWorker *worker, std::function<T(Engine*)> request, T fallback)
+{
+	std::shared_ptr<std::promise<T>> promise = std::make_shared<std::promise<T>>();
+	std::future<T> future = promise->get_future();
+	worker->Push([promise, request, fallback](Engine *engine, bool cancelled)
+	{
+		promise->set_value(cancelled ? fallback : request(engine));
+	});
+	return future;
+}
+
+std::future<void> EngineWorker::Configure(uint8_t level, uint32_t hash_mb, uint8_t threads)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_sent_valid = false;
+	}
+
+	std::shared_ptr<std::promise<void>> promise = std::make_shared<std::promise<void>>();
+	std::future<void> future = promise->get_future();
+	Push([promise, level, hash_mb, threads](Engine *engine, bool cancelled)
+	{
+		if(!cancelled)
+		{
+			engine->SetLevel(level);
+			engine->SetHash(hash_mb);
+			engine->SetThreads(threads);
+			engine->NewGame();
+		}
+		promise->set_value();
+	});
+	return future;
+}
+
+std::future<void> EngineWorker::NewGame(uint8_t level)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_sent_valid = false;
+	}
+
+	std::shared_ptr<std::promise<void>> promise = std::make_shared<std::promise<void>>();
+	std::future<void> future = promise->get_future();
+	Push([promise, level](Engine *engine, bool cancelled)
+	{
+		if(!cancelled)
+		{
+			engine->SetLevel(level);
+			engine->NewGame();
+		}
+		promise->set_value();
+	});
+	return future;
+}
+
+std::future<std::string> EngineWorker::GetBestMove(Board &board, SwitchState state)
+{
+	PositionUpdate update = MakeUpdate(board);
+	return PushRequest<std::string>(this, [update, state](Engine *engine) mutable
+	{
+		update.Apply(engine);
+		engine->SetSwitchState(state);
+		return engine->GetBestMove();
+	}, "");
+}
+
+std::future<PassDecision> EngineWorker::DecidePass(Board &board, SwitchState state)
+{
+	PositionUpdate update = MakeUpdate(board);
+	return PushRequest<PassDecision>(this, [update, state](Engine *engine) mutable
+	{
+		update.Apply(engine);
+		engine->SetSwitchState(state);
+		return engine->DecidePass();
+	}, PassDecision());
+}
+
+// SEARCHES THE REPLY THE LAST BEST MOVE EXPECTED WHILE THE OPPONENT THINKS, board IS THE POSITION AFTER
+// THE ENGINE'S MOVE. THE FUTURE ONLY COUNTS AFTER PonderHit, AND ANSWERS "" WHEN THERE WAS NOTHING TO PONDER
+std::future<std::string> EngineWorker::Ponder(Board &board, SwitchState state)
+{
+	PositionUpdate update = MakeUpdate(board);
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		// THE ROOT MOVES ON BY A MOVE THE CALLER HAS NOT PLAYED YET
+		_sent_valid = false;
+		_ponder_queued = true;
+		_ponder_ply = board._move_history.size();
+		_ponder_hash = board._hash;
+		_ponder_move = MOVE_NONE;
+	}
+
+	return PushRequest<std::string>(this, [this, update, state](Engine *engine) mutable
+	{
+		update.Apply(engine);
+		engine->SetSwitchState(state);
+		PackedMove expected = engine->PlayPonderMove();
+		if(expected == MOVE_NONE) return std::string("");
+		{
+			// A CANCEL THAT CAME AFTER THIS JOB LEFT THE QUEUE MUST NOT BE UNDONE BY STARTING AN UNTIMED SEARCH
+			std::lock_guard<std::mutex> lock(_mutex);
+			if(!_ponder_queued) return std::string("");
+			_ponder_queued = false;
+			_ponder_move = expected;
+			engine->_pondering = true;
+		}
+		std::string move = engine->GetBestMove();
+		engine->_pondering = false;
+		return move;
+	}, "");
+}
+
+// CALLED ONCE THE OPPONENT HAS MOVED. ON A HIT THE PONDER FUTURE BECOMES THE ANSWER FOR board, ON A MISS
+// THE PONDER IS CANCELLED AND THE CALLER ASKS FOR A NEW SEARCH
+bool EngineWorker::PonderHit(Board &board)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		uint32_t ply = board._move_history.size();
+		bool hit = _ponder_move != MOVE_NONE && ply == _ponder_ply+1 && board._hash_history[_ponder_ply] == _ponder_hash
+			&& board._move_history[_ponder_ply]._move == _ponder_move;
+		if(hit)
+		{
+			_engine->PonderHit();
+			_ponder_move = MOVE_NONE;
+			_sent_valid = true;
+			_sent_ply = ply;
+			_sent_hash = board._hash;
+			return true;
+		}
+	}
+	Cancel();
+	return false;
+}
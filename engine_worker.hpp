@@ -0,0 +1,79 @@
+#ifndef ENGINE_WORKER_HPP
+#define ENGINE_WORKER_HPP
+
+#include <engine.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// INFO REPORTS KEPT FOR POLLING, THE OLDEST ARE DROPPED WHEN NOBODY READS THEM
+#define INFO_QUEUE_SIZE 64
+
+// A QUEUED REQUEST. cancelled IS TRUE WHEN THE JOB IS DROPPED BEFORE IT RAN, SO IT CAN STILL SETTLE ITS FUTURE
+typedef std::function<void(Engine *engine, bool cancelled)> EngineJob;
+
+// POSITION SENT WITH A REQUEST: THE MOVES PLAYED SINCE THE PREVIOUS REQUEST, OR THE WHOLE BOARD WHEN
+// THE NEW POSITION DOES NOT CONTINUE THE OLD ONE
+struct PositionUpdate
+{
+	std::shared_ptr<Board> _board;
+	std::vector<PackedMove> _moves;
+
+	void Apply(Engine *engine);
+};
+
+// ONE LONG LIVED THREAD OWNS THE ENGINE AND RUNS REQUESTS IN ORDER. CALLERS POLL THE RETURNED FUTURE,
+// AND THE BOARD IS READ ONLY ON THE CALLER'S THREAD, SO NOTHING IS SHARED WITH THE SEARCH WHILE IT RUNS
+struct EngineWorker
+{
+	Engine *_engine;
+	std::thread _thread;
+	std::mutex _mutex;
+	std::condition_variable _wake;
+	std::deque<EngineJob> _jobs;
+	bool _quit;
+
+	// ROOT THE ENGINE WILL HAVE ONCE EVERY QUEUED JOB HAS RUN, CLEARED WHEN THAT CANNOT BE TRUSTED
+	bool _sent_valid;
+	uint32_t _sent_ply;
+	uint64_t _sent_hash;
+
+	// PONDER IN FLIGHT: THE POSITION IT STARTED FROM AND THE REPLY IT IS SEARCHING, MOVE_NONE UNTIL IT RUNS
+	bool _ponder_queued;
+	uint32_t _ponder_ply;
+	uint64_t _ponder_hash;
+	PackedMove _ponder_move;
+
+	std::deque<SearchInfo> _infos;	// REPORTS OF THE RUNNING SEARCH, OLDEST FIRST
+
+	EngineWorker(Engine *engine);
+	~EngineWorker();
+
+	void Push(EngineJob job);
+	void Cancel();	// DROPS QUEUED JOBS AND STOPS THE RUNNING SEARCH
+	void Loop();
+	PositionUpdate MakeUpdate(Board &board);
+
+	std::future<void> Configure(uint8_t level, uint32_t hash_mb, uint8_t threads);
+	std::future<void> NewGame(uint8_t level);
+	std::future<std::string> GetBestMove(Board &board, SwitchState state);
+	std::future<PassDecision> DecidePass(Board &board, SwitchState state);
+	std::future<std::string> Ponder(Board &board, SwitchState state);
+	bool PonderHit(Board &board);
+	bool PollInfo(SearchInfo &info);
+};
+
+// TRUE ONCE THE FUTURE HOLDS A RESULT, WITHOUT BLOCKING
+template<typename T>
+inline bool IsReady(std::future<T> &future)
+{
+	return future.valid() && future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+#endif
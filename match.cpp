@@ -0,0 +1,202 @@
+#include <match.hpp>
+
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+void MatchStats::Add(MatchGame &game)
+{
+	_games++;
+	_wins[game._winner]++;
+	_plies += game._plies;
+	_nodes += game._nodes;
+	_search_ms += game._search_ms;
+}
+
+double MatchStats::GamesPerSecond()
+{
+	return (_seconds > 0) ? _games/_seconds : 0.0;
+}
+
+double MatchStats::NodesPerSecond()
+{
+	return (_search_ms > 0) ? _nodes*1000.0/_search_ms : 0.0;
+}
+
+const char *GetResultString(uint8_t winner)
+{
+	if(winner == SWITCH_PLAYER_1) return "1-0";
+	if(winner == SWITCH_PLAYER_2) return "0-1";
+	return "1/2-1/2";
+}
+
+std::string GetMatchGameCSV(MatchGame &game)
+{
+	char line[256];
+	snprintf(line, sizeof(line), "%u,%u,%u,%s,%llu,%s,%u,%u,%u,%u,%llu,%llu", game._index, game._level[0], game._level[1],
+		game._first_color == COLOR_W ? "white" : "black", (unsigned long long)game._card_seed, GetResultString(game._winner),
+		game._plies, game._cards, game._switches, game._passes, (unsigned long long)game._nodes, (unsigned long long)game._search_ms);
+	return line;
+}
+
+void GetMatchGamePgn(MatchGame &game, PgnGame &pgn)
+{
+	uint8_t white = (game._first_color == COLOR_W) ? SWITCH_PLAYER_1 : SWITCH_PLAYER_2;
+	pgn.Clear();
+	pgn.SetTag("Event", "Switch Chess match");
+	pgn.SetTag("Site", "?");
+	pgn.SetTag("Date", "????.??.??");
+	pgn.SetTag("Round", std::to_string(game._index+1));
+	pgn.SetTag("White", "Level " + std::to_string(game._level[white]));
+	pgn.SetTag("Black", "Level " + std::to_string(game._level[1-white]));
+
+	if(game._winner == SWITCH_DRAW) pgn._result = "1/2-1/2";
+	else pgn._result = (game._winner == white) ? "1-0" : "0-1";
+	pgn.SetTag("Result", pgn._result);
+	pgn.SetTag("Variant", "Switch Chess");
+	pgn.SetTag("CardSeed", std::to_string(game._card_seed));
+	pgn._events = game._events;
+}
+
+// SPLITMIX, SO NEIGHBOURING GAME NUMBERS GET UNRELATED CARD SEQUENCES
+uint64_t CardSeed(uint64_t seed, uint32_t index)
+{
+	uint64_t z = seed + (index+1)*0x9E3779B97F4A7C15ull;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
+}
+
+static void SetupEngine(Engine *engine, Board &board, SwitchChessGame &rules, uint8_t player)
+{
+	engine->SetPosition(board);
+	engine->SetSwitchState(rules.GetSwitchState(player));
+}
+
+void PlayMatchGame(Engine *engines[2], MatchConfig &config, MatchGame &game)
+{
+	Board board;
+	SwitchChessGame rules(&board);
+	rules.Reset(game._first_color, game._card_seed);
+
+	for(uint8_t p = 0; p < 2; p++)
+	{
+		engines[p]->SetLevel(game._level[p]);
+		engines[p]->SetMoveTime(config._move_time);
+		// THE NOISE SEED COMES FROM THE CARD SEED, SO THE SAME --seed REPLAYS THE SAME GAMES
+		engines[p]->NewGame(CardSeed(game._card_seed, p));
+	}
+
+	while(rules._phase != SWITCH_FINISHED)
+	{
+		if(rules._phase == SWITCH_PLAYING)
+		{
+			if(game._plies >= config._max_plies) break;
+
+			Engine *engine = engines[rules.PlayerToMove()];
+			SetupEngine(engine, board, rules, rules.PlayerToMove());
+			SearchResult result = engine->Search(engine->GetLevelLimits());
+			game._nodes += result._nodes;
+			game._search_ms += result._time;
+
+			if(!rules.PlayMove(result._best_move)) break;
+			game._plies++;
+		}
+		else if(rules._phase == SWITCH_DRAW_CARD)
+		{
+			rules.DrawCard();
+			game._cards++;
+		}
+		else
+		{
+			for(uint8_t p = 0; p < 2; p++)
+			{
+				if(rules._pass_decided[p]) continue;
+
+				// EACH PLAYER DECIDES ON THE POSITION ALONE, NEITHER SEES THE OTHER'S CHOICE
+				SetupEngine(engines[p], board, rules, p);
+				bool use = engines[p]->DecidePass()._use_pass;
+				if(use) game._passes++;
+				rules.UsePass(p, use);
+			}
+		}
+	}
+
+	game._winner = rules.GetWinner();
+	game._events = rules._events;
+	// A SWITCH CARD DRAWN WHEN NOBODY HOLDS A PASS SWITCHES AT ONCE, WITHOUT A DECISION, SO ONLY THE EVENTS SEE THEM ALL
+	for(SwitchEvent &event : game._events)
+	{
+		if(event._type == EVENT_SWITCH) game._switches++;
+	}
+}
+
+struct MatchRun
+{
+	MatchConfig *config;
+	GameSink *sink;
+	MatchStats *stats;
+	std::mutex mutex;
+	std::atomic<uint32_t> next;
+	std::atomic<bool> stop;
+};
+
+static void MatchWorker(MatchRun *run)
+{
+	MatchConfig &config = *run->config;
+
+	Engine *engines[2];
+	for(uint8_t p = 0; p < 2; p++)
+	{
+		engines[p] = new Engine;
+		engines[p]->SetHash(config._hash_mb);
+	}
+
+	uint32_t i;
+	while(!run->stop && (i = run->next++) < config._games)
+	{
+		MatchGame game;
+		game._index = i;
+		game._level[SWITCH_PLAYER_1] = config._level[SWITCH_PLAYER_1];
+		game._level[SWITCH_PLAYER_2] = config._level[SWITCH_PLAYER_2];
+		game._first_color = (i & 1) ? COLOR_B : COLOR_W;
+		game._card_seed = CardSeed(config._seed, i);
+		PlayMatchGame(engines, config, game);
+
+		std::lock_guard<std::mutex> lock(run->mutex);
+		run->stats->Add(game);
+		if(*run->sink && !(*run->sink)(game)) run->stop = true;
+	}
+
+	delete engines[0];
+	delete engines[1];
+}
+
+MatchStats RunMatch(MatchConfig &config, GameSink sink)
+{
+	MatchStats stats;
+
+	MatchRun run;
+	run.config = &config;
+	run.sink = &sink;
+	run.stats = &stats;
+	run.next = 0;
+	run.stop = false;
+
+	auto start = std::chrono::steady_clock::now();
+	std::vector<std::thread> workers;
+	for(uint8_t t = 1; t < config._threads; t++)
+	{
+		workers.push_back(std::thread(MatchWorker, &run));
+	}
+	MatchWorker(&run);
+	for(std::thread &worker : workers)
+	{
+		worker.join();
+	}
+	stats._seconds = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+
+	return stats;
+}
@@ -0,0 +1,75 @@
+#ifndef MATCH_HPP
+#define MATCH_HPP
+
+#include <chess.hpp>
+#include <engine.hpp>
+#include <switch_chess_game.hpp>
+#include <pgn.hpp>
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// HEADLESS ENGINE AGAINST ENGINE SWITCH CHESS GAMES, PLAYED ON A POOL OF THREADS. EVERY THREAD OWNS ONE
+// SINGLE THREADED ENGINE PER PLAYER AND PLAYS WHOLE GAMES ON ITS OWN, SO GAMES NEVER WAIT ON EACH OTHER
+
+struct MatchConfig
+{
+	uint32_t _games = 100;
+	uint8_t _threads = 1;
+	uint8_t _level[2] = {LEVEL_MAX, LEVEL_MAX};	// [PLAYER]
+	uint32_t _move_time = 0;	// MILLISECONDS PER MOVE, 0 KEEPS EACH LEVEL'S OWN TIME
+	uint32_t _hash_mb = 4;		// PER ENGINE
+	uint64_t _seed = 1;			// GAME i DRAWS ITS CARDS AND ENGINE NOISE FROM A SEED DERIVED FROM THIS AND i
+	uint16_t _max_plies = 600;	// LONGER GAMES ARE SCORED AS DRAWS
+};
+
+struct MatchGame
+{
+	uint32_t _index = 0;
+	uint8_t _level[2] = {0, 0};
+	uint8_t _first_color = COLOR_W;	// PLAYER 1'S COLOUR AT THE START, ALTERNATES BY GAME
+	uint64_t _card_seed = 0;
+	uint8_t _winner = SWITCH_DRAW;
+	uint16_t _plies = 0;
+	uint16_t _cards = 0;
+	uint16_t _switches = 0;		// SWITCHES THAT WENT THROUGH
+	uint16_t _passes = 0;		// PASSES SPENT
+	uint64_t _nodes = 0;
+	uint64_t _search_ms = 0;
+	std::vector<SwitchEvent> _events;	// MOVES, CARDS, PASSES AND SWITCHES IN PLAY ORDER
+};
+
+struct MatchStats
+{
+	uint32_t _games = 0;
+	uint32_t _wins[3] = {0, 0, 0};	// [SWITCH_PLAYER_1, SWITCH_PLAYER_2, SWITCH_DRAW]
+	uint64_t _plies = 0;
+	uint64_t _nodes = 0;
+	uint64_t _search_ms = 0;	// SUMMED OVER THREADS
+	double _seconds = 0;		// WALL CLOCK
+
+	void Add(MatchGame &game);
+	double GamesPerSecond();
+	double NodesPerSecond();	// PER SEARCHING THREAD
+};
+
+// ONE CSV LINE PER GAME, RESULTS ARE FROM PLAYER 1'S SIDE
+#define MATCH_CSV_HEADER "game,level1,level2,player1_color,card_seed,result,plies,cards,switches,passes,nodes,search_ms"
+
+const char *GetResultString(uint8_t winner);
+std::string GetMatchGameCSV(MatchGame &game);
+
+// White AND Black ARE THE PLAYERS BY THEIR STARTING COLOURS, NAMED "Level N"
+void GetMatchGamePgn(MatchGame &game, PgnGame &pgn);
+
+// CALLED ONCE PER FINISHED GAME, ONE AT A TIME, IN THE ORDER THE GAMES FINISH. RETURNING FALSE ENDS THE
+// MATCH EARLY: NO NEW GAME STARTS, THE ONES ALREADY RUNNING STILL FINISH AND ARE REPORTED
+typedef std::function<bool(MatchGame &game)> GameSink;
+
+uint64_t CardSeed(uint64_t seed, uint32_t index);
+void PlayMatchGame(Engine *engines[2], MatchConfig &config, MatchGame &game);
+MatchStats RunMatch(MatchConfig &config, GameSink sink);
+
+#endif
@@ -0,0 +1,233 @@
+#include <chess.hpp>
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// USAGE
+//   mock_uci [--latency MS] [--depth N] [--mate M1,M2,...] [--seed S]
+//
+// A STAND-IN UCI ENGINE FOR TESTS AND LOAD RUNS: IT SPEAKS uci/isready/ucinewgame/position/go/stop/quit,
+// WAITS --latency MILLISECONDS PER go (CUT SHORT BY stop), PRINTS ONE info LINE PER DEPTH UP TO --depth
+// AND ANSWERS WITH A LEGAL MOVE PICKED BY A SEEDED RANDOM GENERATOR, SO RUNS ARE REPEATABLE.
+// --mate SCRIPTS THE SCORE OF SUCCESSIVE go COMMANDS: A NON ZERO ENTRY IS REPORTED AS "score mate N",
+// 0 AS THE MATERIAL BALANCE IN CENTIPAWNS. THE LAST ENTRY REPEATS ONCE THE SCRIPT RUNS OUT.
+// Latency AND Depth CAN ALSO BE SET WITH setoption.
+
+struct MockEngine
+{
+	Board _board;
+	uint32_t _latency = 0;
+	uint32_t _depth = 1;
+	std::vector<int32_t> _mates;
+	uint32_t _go_count = 0;
+	uint64_t _seed = 1;
+
+	std::thread _thinker;
+	std::mutex _mutex;
+	std::condition_variable _wake;
+	bool _stop = false;
+
+	uint64_t Random();
+	void Position(std::istringstream &args);
+	void Go(std::istringstream &args);
+	void Think(uint32_t latency, uint32_t depth, int32_t mate);
+	void Stop();
+};
+
+static std::mutex OutputMutex;
+
+static void Send(std::string line)
+{
+	std::lock_guard<std::mutex> lock(OutputMutex);
+	printf("%s\n", line.c_str());
+	fflush(stdout);
+}
+
+uint64_t MockEngine::Random()
+{
+	_seed ^= _seed << 13;
+	_seed ^= _seed >> 7;
+	_seed ^= _seed << 17;
+	return _seed;
+}
+
+void MockEngine::Position(std::istringstream &args)
+{
+	std::string token;
+	args >> token;
+	if(token == "startpos")
+	{
+		_board.Reset();
+		args >> token;
+	}
+	else if(token == "fen")
+	{
+		std::string fen;
+		while(args >> token && token != "moves")
+		{
+			fen += (fen.empty() ? "" : " ") + token;
+		}
+		_board.SetPositionFromFENString(fen);
+	}
+
+	if(token != "moves") return;
+	while(args >> token)
+	{
+		_board.MakeMove(token);
+	}
+}
+
+void MockEngine::Go(std::istringstream &args)
+{
+	uint32_t latency = _latency;
+	uint32_t depth = _depth;
+
+	std::string token;
+	while(args >> token)
+	{
+		if(token == "depth" && args >> token) depth = atoi(token.c_str());
+		else if(token == "movetime" && args >> token)
+		{
+			uint32_t move_time = atoi(token.c_str());
+			if(move_time < latency) latency = move_time;
+		}
+	}
+	if(depth < 1) depth = 1;
+
+	int32_t mate = 0;
+	if(!_mates.empty()) mate = _mates[(_go_count < _mates.size()) ? _go_count : _mates.size()-1];
+	_go_count++;
+
+	Stop();
+	_stop = false;
+	_thinker = std::thread(&MockEngine::Think, this, latency, depth, mate);
+}
+
+void MockEngine::Think(uint32_t latency, uint32_t depth, int32_t mate)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	MoveList moves;
+	_board.GetAllLegalMoves(_board._current_color, moves);
+	if(moves.Size() == 0)
+	{
+		Send(_board.IsInCheck(_board._current_color) ? "info depth 0 score mate 0" : "info depth 0 score cp 0");
+		Send("bestmove (none)");
+		return;
+	}
+	PackedMove best = moves[Random() % moves.Size()];
+
+	int32_t cp = _board.GetMaterial(COLOR_ALL);
+	if(_board._current_color == COLOR_B) cp = -cp;
+	std::string score = (mate != 0) ? "score mate " + std::to_string(mate) : "score cp " + std::to_string(cp);
+
+	// THE LATENCY IS SPREAD OVER THE DEPTHS, SO info LINES ARRIVE THE WAY A REAL SEARCH SENDS THEM
+	for(uint32_t d = 1; d <= depth; d++)
+	{
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			std::chrono::steady_clock::time_point until = start + std::chrono::milliseconds((uint64_t)latency*d/depth);
+			if(_wake.wait_until(lock, until, [this]{ return _stop; })) break;
+		}
+
+		uint32_t time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now()-start).count();
+		uint64_t nodes = (uint64_t)d*moves.Size();
+		Send("info depth " + std::to_string(d) + " " + score + " nodes " + std::to_string(nodes) +
+			" nps " + std::to_string(nodes*1000 / (time ? time : 1)) + " time " + std::to_string(time) + " pv " + GetMoveString(best));
+	}
+	Send("bestmove " + GetMoveString(best));
+}
+
+void MockEngine::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_wake.notify_one();
+	if(_thinker.joinable()) _thinker.join();
+}
+
+int main(int argc, char **argv)
+{
+	MockEngine engine;
+
+	for(int i = 1; i+1 < argc; i += 2)
+	{
+		if(strcmp(argv[i], "--latency") == 0) engine._latency = atoi(argv[i+1]);
+		else if(strcmp(argv[i], "--depth") == 0) engine._depth = atoi(argv[i+1]);
+		else if(strcmp(argv[i], "--seed") == 0) engine._seed = strtoull(argv[i+1], nullptr, 10) | 1;
+		else if(strcmp(argv[i], "--mate") == 0)
+		{
+			std::stringstream list(argv[i+1]);
+			std::string entry;
+			while(std::getline(list, entry, ','))
+			{
+				engine._mates.push_back(atoi(entry.c_str()));
+			}
+		}
+		else
+		{
+			printf("usage: mock_uci [--latency MS] [--depth N] [--mate M1,M2,...] [--seed S]\n");
+			return 1;
+		}
+	}
+	if(engine._depth < 1) engine._depth = 1;
+
+	std::string line;
+	while(std::getline(std::cin, line))
+	{
+		if(!line.empty() && line.back() == '\r') line.pop_back();
+
+		std::istringstream args(line);
+		std::string command;
+		args >> command;
+
+		if(command == "uci")
+		{
+			Send("id name MockUCI");
+			Send("id author Switch Chess");
+			Send("option name Latency type spin default " + std::to_string(engine._latency) + " min 0 max 600000");
+			Send("option name Depth type spin default " + std::to_string(engine._depth) + " min 1 max 64");
+			Send("uciok");
+		}
+		else if(command == "isready") Send("readyok");
+		else if(command == "ucinewgame")
+		{
+			engine.Stop();
+			engine._board.Reset();
+			engine._go_count = 0;
+		}
+		else if(command == "setoption")
+		{
+			std::string token, name, value;
+			while(args >> token)
+			{
+				if(token == "name") args >> name;
+				else if(token == "value") args >> value;
+			}
+			if(name == "Latency") engine._latency = atoi(value.c_str());
+			else if(name == "Depth" && atoi(value.c_str()) > 0) engine._depth = atoi(value.c_str());
+		}
+		else if(command == "position")
+		{
+			engine.Stop();
+			engine.Position(args);
+		}
+		else if(command == "go") engine.Go(args);
+		else if(command == "stop") engine.Stop();
+		else if(command == "quit") break;
+	}
+
+	engine.Stop();
+	return 0;
+}
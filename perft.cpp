@@ -0,0 +1,206 @@
+#include <chess.hpp>
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+// USAGE
+//   perft <depth> [fen] [--threads N] [--crosscheck]
+//   perft --suite [--threads N] [--crosscheck]
+//
+// <depth> prints the node count below every root move (divide) followed by the total and nodes/sec.
+// --threads fans the root moves out over N worker threads, each on its own copy of the board.
+// --crosscheck recounts every root move with the make/unmake legality filter and flags mismatches.
+// --suite runs the reference positions below and exits non-zero if any count is off.
+
+#define START_FEN "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"
+
+struct PerftCase
+{
+	const char *fen;
+	uint8_t depth;
+	uint64_t nodes;
+};
+
+static const PerftCase Suite[] = {
+	{START_FEN, 5, 4865609},
+	{"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 4, 4085603},
+	{"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 6, 11030083},
+	{"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 5, 15833292},
+	{"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 4, 2103487},
+	{"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 4, 3894594},
+	{"8/8/1k6/2b5/2pP4/8/5K2/8 b - d3 0 1", 6, 1440467},
+	{"3k4/3p4/8/K1P4r/8/8/8/8 b - - 0 1", 6, 1134888},
+	{"8/5bk1/8/2Pp4/8/1K6/8/8 w - d6 0 1", 6, 824064},
+	{"r3k2r/1b4bq/8/8/8/8/7B/R3K2R w KQkq - 0 1", 4, 1274206},
+	{"2K2r2/4P3/8/8/8/8/8/3k4 w - - 0 1", 6, 3821001},
+	{"8/k1P5/8/1K6/8/8/8/8 w - - 0 1", 7, 567584},
+};
+
+static uint64_t Perft(Board &board, uint8_t depth)
+{
+	MoveList moves;
+	board.GetAllLegalMoves(board._current_color, moves);
+	if(depth <= 1) return moves.Size();
+
+	uint64_t nodes = 0;
+	for(PackedMove move : moves)
+	{
+		board.MakeMove(move);
+		nodes += Perft(board, depth-1);
+		board.UnMakeMove();
+	}
+	return nodes;
+}
+
+struct Divide
+{
+	Board *board;
+	MoveList *roots;
+	uint64_t *counts;
+	uint64_t *checks;
+	uint8_t depth;
+	bool crosscheck;
+	std::atomic<uint16_t> next;
+};
+
+static void DivideWorker(Divide *divide)
+{
+	Board board = *divide->board;
+	uint16_t i;
+	while((i = divide->next++) < divide->roots->Size())
+	{
+		PackedMove move = (*divide->roots)[i];
+		board.MakeMove(move);
+		board._make_move_legality = false;
+		divide->counts[i] = (divide->depth > 1) ? Perft(board, divide->depth-1) : 1;
+		if(divide->crosscheck)
+		{
+			board._make_move_legality = true;
+			divide->checks[i] = (divide->depth > 1) ? Perft(board, divide->depth-1) : 1;
+		}
+		board.UnMakeMove();
+	}
+}
+
+// RETURNS THE TOTAL NODE COUNT, OR -1 WHEN THE CROSS-CHECK DISAGREES
+static int64_t RunDivide(std::string fen, uint8_t depth, uint8_t threads, bool crosscheck, bool print)
+{
+	Board board;
+	board.SetPositionFromFENString(fen);
+
+	MoveList roots;
+	board.GetAllLegalMoves(board._current_color, roots);
+
+	uint64_t counts[MAX_MOVES] = {0};
+	uint64_t checks[MAX_MOVES] = {0};
+
+	Divide divide;
+	divide.board = &board;
+	divide.roots = &roots;
+	divide.counts = counts;
+	divide.checks = checks;
+	divide.depth = depth;
+	divide.crosscheck = crosscheck;
+	divide.next = 0;
+
+	auto start = std::chrono::steady_clock::now();
+	std::vector<std::thread> workers;
+	for(uint8_t t = 1; t < threads; t++)
+	{
+		workers.push_back(std::thread(DivideWorker, &divide));
+	}
+	DivideWorker(&divide);
+	for(std::thread &worker : workers)
+	{
+		worker.join();
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+
+	uint64_t total = 0;
+	bool mismatch = false;
+	for(uint16_t i = 0; i < roots.Size(); i++)
+	{
+		total += counts[i];
+		if(crosscheck && counts[i] != checks[i])
+		{
+			mismatch = true;
+			printf("%s: %llu MISMATCH make/unmake %llu\n", GetMoveString(roots[i]).c_str(), (unsigned long long)counts[i], (unsigned long long)checks[i]);
+		}
+		else if(print)
+		{
+			printf("%s: %llu\n", GetMoveString(roots[i]).c_str(), (unsigned long long)counts[i]);
+		}
+	}
+
+	if(print)
+	{
+		printf("\nNodes searched: %llu\n", (unsigned long long)total);
+		printf("Time: %.3fs\n", seconds);
+		// A CROSS-CHECK COUNTS EVERY NODE TWICE, SO ITS RATE IS NOT A THROUGHPUT FIGURE
+		if(!crosscheck) printf("Nodes/sec: %.0f\n", seconds > 0 ? total/seconds : 0.0);
+	}
+	fflush(stdout);
+
+	return mismatch ? -1 : (int64_t)total;
+}
+
+static int RunSuite(uint8_t threads, bool crosscheck)
+{
+	int failed = 0;
+	uint64_t total = 0;
+	auto start = std::chrono::steady_clock::now();
+
+	for(const PerftCase &c : Suite)
+	{
+		int64_t nodes = RunDivide(c.fen, c.depth, threads, crosscheck, false);
+		bool ok = (nodes == (int64_t)c.nodes);
+		if(!ok) failed++;
+		if(nodes > 0) total += nodes;
+		printf("%s depth %d: %lld (expected %llu) %s\n", c.fen, c.depth, (long long)nodes, (unsigned long long)c.nodes, ok ? "ok" : "FAILED");
+	}
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+	printf("\n%d of %d positions failed\n", failed, (int)(sizeof(Suite)/sizeof(Suite[0])));
+	printf("Nodes searched: %llu\n", (unsigned long long)total);
+	printf("Time: %.3fs\n", seconds);
+	if(!crosscheck) printf("Nodes/sec: %.0f\n", seconds > 0 ? total/seconds : 0.0);
+	fflush(stdout);
+
+	return failed ? 1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+	int depth = 0;
+	bool suite = false;
+	bool crosscheck = false;
+	int threads = 1;
+	std::string fen = START_FEN;
+
+	for(int i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "--suite") == 0) suite = true;
+		else if(strcmp(argv[i], "--crosscheck") == 0) crosscheck = true;
+		else if(strcmp(argv[i], "--threads") == 0 && i+1 < argc) threads = atoi(argv[++i]);
+		else if(depth == 0) depth = atoi(argv[i]);
+		else fen = argv[i];
+	}
+
+	if(threads < 1) threads = 1;
+	if(threads > 255) threads = 255;
+
+	if(suite) return RunSuite(threads, crosscheck);
+
+	if(depth < 1)
+	{
+		printf("usage: perft <depth> [fen] [--threads N] [--crosscheck]\n");
+		printf("       perft --suite [--threads N] [--crosscheck]\n");
+		return 1;
+	}
+
+	return RunDivide(fen, depth, threads, crosscheck, true) < 0 ? 1 : 0;
+}
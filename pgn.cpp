@@ -0,0 +1,343 @@
+#include <pgn.hpp>
+
+#include <ctype.h>
+#include <string.h>
+
+void PgnGame::Clear()
+{
+	_tags.clear();
+	_events.clear();
+	_result = "*";
+	_valid = true;
+}
+
+std::string PgnGame::GetTag(std::string name)
+{
+	for(std::pair<std::string, std::string> &tag : _tags)
+	{
+		if(tag.first == name) return tag.second;
+	}
+	return "";
+}
+
+void PgnGame::SetTag(std::string name, std::string value)
+{
+	for(std::pair<std::string, std::string> &tag : _tags)
+	{
+		if(tag.first == name)
+		{
+			tag.second = value;
+			return;
+		}
+	}
+	_tags.push_back(std::make_pair(name, value));
+}
+
+// BREAKS THE MOVETEXT INTO LINES NO WIDER THAN PGN_LINE_WIDTH
+struct PgnLine
+{
+	FILE *file;
+	size_t width;
+
+	void Write(std::string token)
+	{
+		if(width > 0 && width+1+token.size() > PGN_LINE_WIDTH)
+		{
+			fputc('\n', file);
+			width = 0;
+		}
+		if(width > 0)
+		{
+			fputc(' ', file);
+			width++;
+		}
+		fputs(token.c_str(), file);
+		width += token.size();
+	}
+};
+
+static std::string ColorName(uint8_t color)
+{
+	return (color == COLOR_W) ? "white" : "black";
+}
+
+void WritePgn(FILE *file, PgnGame &game)
+{
+	for(std::pair<std::string, std::string> &tag : game._tags)
+	{
+		std::string value;
+		for(char c : tag.second)
+		{
+			if(c == '"' || c == '\\') value += '\\';
+			value += c;
+		}
+		fprintf(file, "[%s \"%s\"]\n", tag.first.c_str(), value.c_str());
+	}
+	fputc('\n', file);
+
+	Board board;
+	std::string fen = game.GetTag("FEN");
+	if(!fen.empty()) board.SetPositionFromFENString(fen);
+
+	PgnLine line = {file, 0};
+	bool number_due = true;	// A BLACK MOVE RIGHT AFTER A COMMENT NEEDS ITS NUMBER AGAIN
+	std::string commands;
+
+	for(size_t i = 0; i <= game._events.size(); i++)
+	{
+		bool is_move = (i < game._events.size() && game._events[i]._type == EVENT_MOVE);
+		if((is_move || i == game._events.size()) && !commands.empty())
+		{
+			line.Write("{" + commands + "}");
+			commands.clear();
+			number_due = true;
+		}
+		if(i == game._events.size()) break;
+
+		SwitchEvent &event = game._events[i];
+		if(event._type == EVENT_MOVE)
+		{
+			// A MOVE NUMBER AND ITS MOVE GO ON ONE LINE
+			std::string unit;
+			if(board._current_color == COLOR_W) unit = std::to_string(board._full_move_clock) + ". ";
+			else if(number_due) unit = std::to_string(board._full_move_clock) + "... ";
+			number_due = false;
+
+			line.Write(unit + board.GetSANString(event._move));
+			board.MakeMove(event._move);
+		}
+		else
+		{
+			if(!commands.empty()) commands += " ";
+			if(event._type == EVENT_CARD) commands += (event._card == CARD_SWITCH) ? "[%card switch]" : "[%card plus5]";
+			else if(event._type == EVENT_PASS) commands += "[%pass " + ColorName(event._color) + (event._use ? " use]" : " keep]");
+			else commands += "[%switch]";
+		}
+	}
+
+	line.Write(game._result);
+	fputs("\n\n", file);
+}
+
+PgnReader::PgnReader(FILE *file)
+{
+	_file = file;
+}
+
+void PgnReader::SkipLine()
+{
+	int c;
+	while((c = fgetc(_file)) != EOF && c != '\n');
+}
+
+// [Name "Value"], THE OPENING BRACKET ALREADY READ
+void PgnReader::ReadTag(PgnGame &game)
+{
+	std::string name, value;
+	int c;
+	while((c = fgetc(_file)) != EOF && isspace(c));
+	while(c != EOF && !isspace(c) && c != '"' && c != ']')
+	{
+		name += (char)c;
+		c = fgetc(_file);
+	}
+	while(c != EOF && c != '"' && c != ']' && c != '\n') c = fgetc(_file);
+	if(c == '"')
+	{
+		while((c = fgetc(_file)) != EOF && c != '"' && c != '\n')
+		{
+			if(c == '\\') c = fgetc(_file);
+			if(c != EOF && value.size() < PGN_COMMENT_MAX) value += (char)c;
+		}
+	}
+	SkipLine();
+	if(!name.empty()) game.SetTag(name, value);
+}
+
+// DROPS WHATEVER FOLLOWS A RESULT UP TO THE NEXT GAME'S TAGS, SO IT CANNOT START A GAME OF ITS OWN
+void PgnReader::SkipToTags()
+{
+	int c;
+	while((c = fgetc(_file)) != EOF)
+	{
+		if(c == '[')
+		{
+			ungetc(c, _file);
+			return;
+		}
+		if(c == '{') while((c = fgetc(_file)) != EOF && c != '}');
+		else if(c == ';') SkipLine();
+	}
+}
+
+// {...}, THE OPENING BRACE ALREADY READ
+void PgnReader::ReadComment(PgnGame &game)
+{
+	std::string comment;
+	int c;
+	while((c = fgetc(_file)) != EOF && c != '}')
+	{
+		if(comment.size() < PGN_COMMENT_MAX) comment += (char)c;
+	}
+	ReadCommands(comment, game);
+}
+
+// (...), THE OPENING PARENTHESIS ALREADY READ. ONLY THE MAIN LINE IS KEPT
+void PgnReader::SkipVariation()
+{
+	uint32_t depth = 1;
+	int c;
+	while(depth > 0 && (c = fgetc(_file)) != EOF)
+	{
+		if(c == '(') depth++;
+		else if(c == ')') depth--;
+		else if(c == '{') while((c = fgetc(_file)) != EOF && c != '}');
+		else if(c == ';') SkipLine();
+	}
+}
+
+void PgnReader::ReadCommands(std::string &comment, PgnGame &game)
+{
+	size_t at = 0;
+	while((at = comment.find("[%", at)) != std::string::npos)
+	{
+		size_t close = comment.find(']', at);
+		if(close == std::string::npos) break;
+
+		char word[32] = {0}, arg1[32] = {0}, arg2[32] = {0};
+		sscanf(comment.substr(at+2, close-at-2).c_str(), "%31s %31s %31s", word, arg1, arg2);
+		at = close;
+
+		SwitchEvent event;
+		if(strcmp(word, "card") == 0)
+		{
+			event._type = EVENT_CARD;
+			if(strcmp(arg1, "switch") == 0) event._card = CARD_SWITCH;
+			else if(strcmp(arg1, "plus5") == 0) event._card = CARD_PLUS5;
+			else game._valid = false;
+		}
+		else if(strcmp(word, "pass") == 0)
+		{
+			event._type = EVENT_PASS;
+			event._color = (strcmp(arg1, "black") == 0) ? COLOR_B : COLOR_W;
+			event._use = (strcmp(arg2, "use") == 0);
+			if((strcmp(arg1, "white") != 0 && strcmp(arg1, "black") != 0) || (!event._use && strcmp(arg2, "keep") != 0)) game._valid = false;
+		}
+		else if(strcmp(word, "switch") == 0) event._type = EVENT_SWITCH;
+		else continue;	// SOMEONE ELSE'S COMMAND, SUCH AS [%clk]
+
+		game._events.push_back(event);
+	}
+}
+
+// A MOVE, MOVE NUMBER OR RESULT: EVERYTHING UP TO WHITESPACE OR A DELIMITER
+void PgnReader::ReadSymbol(std::string &symbol)
+{
+	symbol.clear();
+	int c;
+	while((c = fgetc(_file)) != EOF)
+	{
+		if(isspace(c) || strchr("{}()[];", c))
+		{
+			ungetc(c, _file);
+			break;
+		}
+		if(symbol.size() < 32) symbol += (char)c;
+	}
+}
+
+bool PgnReader::Next(PgnGame &game)
+{
+	game.Clear();
+
+	bool started = false;	// ANYTHING OF THIS GAME SEEN
+	bool movetext = false;	// PAST THE TAGS
+	std::string symbol;
+
+	while(true)
+	{
+		int c = fgetc(_file);
+		if(c == EOF) return started;
+		if(isspace(c)) continue;
+
+		if(c == '[')
+		{
+			// A GAME WITHOUT A RESULT ENDS WHERE THE NEXT ONE'S TAGS BEGIN
+			if(movetext)
+			{
+				ungetc(c, _file);
+				return true;
+			}
+			started = true;
+			ReadTag(game);
+			continue;
+		}
+		if(c == '%' || c == ';')
+		{
+			SkipLine();
+			continue;
+		}
+
+		// COMMENTS AND ANNOTATIONS BEFORE ANY TAG OR MOVE BELONG TO NO GAME
+		if(!started && (c == '{' || c == '(' || c == '$'))
+		{
+			if(c == '{') while((c = fgetc(_file)) != EOF && c != '}');
+			else if(c == '(') SkipVariation();
+			else ReadSymbol(symbol);
+			continue;
+		}
+
+		started = true;
+		if(!movetext)
+		{
+			movetext = true;
+			_board.Reset();
+			std::string fen = game.GetTag("FEN");
+			if(!fen.empty()) _board.SetPositionFromFENString(fen);
+		}
+
+		if(c == '{') ReadComment(game);
+		else if(c == '(') SkipVariation();
+		else if(c == '$') ReadSymbol(symbol);
+		else
+		{
+			ungetc(c, _file);
+			ReadSymbol(symbol);
+			if(symbol.empty())
+			{
+				fgetc(_file);	// A STRAY ')' OR '}'
+				continue;
+			}
+
+			if(symbol == "1-0" || symbol == "0-1" || symbol == "1/2-1/2" || symbol == "*")
+			{
+				game._result = symbol;
+				SkipToTags();
+				return true;
+			}
+
+			// "12." AND "12..." ARE MOVE NUMBERS, "12.e4" AND "12.0-0" CARRY THEIR MOVE
+			size_t start = 0;
+			while(start < symbol.size() && isdigit(symbol[start])) start++;
+			if(start < symbol.size() && symbol[start] == '.')
+			{
+				while(start < symbol.size() && symbol[start] == '.') start++;
+			}
+			else start = 0;
+			if(start == symbol.size()) continue;
+
+			if(!game._valid) continue;
+			PackedMove move = _board.GetPackedMoveFromSAN(symbol.substr(start));
+			if(move == MOVE_NONE)
+			{
+				game._valid = false;
+				continue;
+			}
+			SwitchEvent event;
+			event._type = EVENT_MOVE;
+			event._move = move;
+			game._events.push_back(event);
+			_board.MakeMove(move);
+		}
+	}
+}
@@ -0,0 +1,54 @@
+#ifndef PGN_HPP
+#define PGN_HPP
+
+#include <chess.hpp>
+#include <switch_chess_game.hpp>
+
+#include <stdio.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+// PGN FOR SWITCH CHESS. THE MOVES ARE PLAIN SAN, SO ANY PGN TOOL CAN READ THE CHESS. THE VARIANT EVENTS
+// RIDE IN COMMENTS AS EMBEDDED COMMANDS RIGHT AFTER THE MOVE THAT TRIGGERED THEM:
+//   {[%card plus5]}  {[%card switch]}  {[%pass white use]}  {[%pass black keep]}  {[%switch]}
+// A PASS NAMES THE COLOUR ITS PLAYER HELD WHEN DECIDING. THE White AND Black TAGS NAME THE PLAYERS BY
+// THEIR STARTING COLOURS, AND Result IS FROM THOSE STARTING COLOURS TOO
+
+#define PGN_LINE_WIDTH 80
+#define PGN_COMMENT_MAX 4096	// LONGER COMMENTS ARE CUT, SO ONE BAD GAME CANNOT GROW THE READER WITHOUT BOUND
+
+struct PgnGame
+{
+	std::vector<std::pair<std::string, std::string>> _tags;	// IN FILE ORDER
+	std::vector<SwitchEvent> _events;
+	std::string _result = "*";
+	bool _valid = true;		// FALSE WHEN A MOVE OR AN EVENT COULD NOT BE READ
+
+	void Clear();
+	std::string GetTag(std::string name);
+	void SetTag(std::string name, std::string value);
+};
+
+// WRITES ONE GAME AND NOTHING ELSE, SO A COLLECTION IS WRITTEN A GAME AT A TIME
+void WritePgn(FILE *file, PgnGame &game);
+
+// READS A COLLECTION ONE GAME AT A TIME, HOLDING ONLY THE GAME BEING READ
+struct PgnReader
+{
+	FILE *_file;
+	Board _board;
+
+	PgnReader(FILE *file);
+	bool Next(PgnGame &game);	// FALSE AT THE END OF THE FILE
+
+	void SkipLine();
+	void SkipToTags();
+	void ReadTag(PgnGame &game);
+	void ReadComment(PgnGame &game);
+	void SkipVariation();
+	void ReadCommands(std::string &comment, PgnGame &game);
+	void ReadSymbol(std::string &symbol);
+};
+
+#endif
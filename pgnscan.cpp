@@ -0,0 +1,99 @@
+#include <pgn.hpp>
+#include <switch_chess_game.hpp>
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+
+// USAGE
+//   pgnscan FILE
+//
+// STREAMS A PGN COLLECTION ("-" FOR STDIN) ONE GAME AT A TIME AND REPLAYS EVERY GAME THROUGH THE SWITCH CHESS
+// RULES, CARDS, PASSES AND SWITCHES INCLUDED. GAMES THAT DO NOT READ OR DO NOT FOLLOW THE RULES ARE LISTED ON
+// STDERR, THE TOTALS GO TO STDOUT. MEMORY STAYS THE SAME WHATEVER THE SIZE OF THE FILE.
+
+#define SCAN_BUFFER_SIZE (1 << 20)
+
+// REPLAYS THE EVENTS IN ORDER, FALSE AT THE FIRST ONE THE RULES REFUSE. THE RULES RECORD THE GAME AS THEY GO,
+// SO A FAITHFUL FILE READS BACK AS EXACTLY THE EVENTS THE RULES RECORDED
+static bool ReplayGame(SwitchChessGame &rules, PgnGame &game)
+{
+	rules.Reset(COLOR_W);
+	std::string fen = game.GetTag("FEN");
+	if(!fen.empty()) rules._board->SetPositionFromFENString(fen);
+
+	for(SwitchEvent &event : game._events)
+	{
+		bool ok = true;
+		if(event._type == EVENT_MOVE) ok = rules.PlayMove(event._move);
+		else if(event._type == EVENT_CARD) ok = rules.DrawCard(event._card);
+		else if(event._type == EVENT_PASS) ok = rules.UsePass(rules.PlayerOfColor(event._color), event._use);
+		if(!ok) return false;
+	}
+
+	// A SWITCH FOLLOWS FROM THE PASSES BEFORE IT, SO IT ONLY HAS TO BE WHERE THE RULES PUT ONE
+	if(rules._events.size() != game._events.size()) return false;
+	for(size_t i = 0; i < game._events.size(); i++)
+	{
+		if(rules._events[i]._type != game._events[i]._type) return false;
+	}
+	return true;
+}
+
+int main(int argc, char **argv)
+{
+	if(argc != 2)
+	{
+		printf("usage: pgnscan FILE\n");
+		return 1;
+	}
+
+	FILE *file = (strcmp(argv[1], "-") == 0) ? stdin : fopen(argv[1], "rb");
+	if(file == nullptr)
+	{
+		fprintf(stderr, "cannot open %s\n", argv[1]);
+		return 1;
+	}
+	setvbuf(file, nullptr, _IOFBF, SCAN_BUFFER_SIZE);
+
+	PgnReader reader(file);
+	PgnGame game;
+	Board board;
+	SwitchChessGame rules(&board);
+
+	uint64_t games = 0, invalid = 0, plies = 0, cards = 0, passes = 0, switches = 0;
+	uint64_t results[3] = {0, 0, 0};	// [WHITE WINS, BLACK WINS, DRAWS], BY STARTING COLOURS
+	auto start = std::chrono::steady_clock::now();
+
+	while(reader.Next(game))
+	{
+		games++;
+		if(!game._valid || !ReplayGame(rules, game))
+		{
+			invalid++;
+			fprintf(stderr, "game %llu: %s\n", (unsigned long long)games, game._valid ? "breaks the rules" : "unreadable");
+			continue;
+		}
+
+		for(SwitchEvent &event : game._events)
+		{
+			if(event._type == EVENT_MOVE) plies++;
+			else if(event._type == EVENT_CARD) cards++;
+			else if(event._type == EVENT_PASS) passes += event._use;
+			else switches++;
+		}
+		if(game._result == "1-0") results[0]++;
+		else if(game._result == "0-1") results[1]++;
+		else if(game._result == "1/2-1/2") results[2]++;
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+	if(file != stdin) fclose(file);
+
+	printf("Games: %llu (%llu invalid)\n", (unsigned long long)games, (unsigned long long)invalid);
+	printf("White/Black/Draw: %llu/%llu/%llu\n", (unsigned long long)results[0], (unsigned long long)results[1], (unsigned long long)results[2]);
+	printf("Plies: %llu\n", (unsigned long long)plies);
+	printf("Cards: %llu, passes used: %llu, switches: %llu\n", (unsigned long long)cards, (unsigned long long)passes, (unsigned long long)switches);
+	printf("Time: %.3fs\n", seconds);
+	printf("Games/sec: %.0f\n", seconds > 0 ? games/seconds : 0.0);
+	return invalid ? 2 : 0;
+}
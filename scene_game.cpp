@@ -1,9 +1,13 @@
 #include <scene_game.hpp>
+#include <pgn.hpp>
 #include <algorithm>
-#include <pthread.h>
+#include <time.h>
+
+#define ARCHIVE_PGN_FILE "games.pgn"
 
 GameBoard::GameBoard()
 {
+    rules = nullptr;
     squares_delay = std::vector<float>(64);
     squares_scale = std::vector<float>(64);
     squares_position = std::vector<Vector2>(64);
@@ -217,7 +221,7 @@ void GameBoard::Process()
         }
         else
         {
-            core->board->MakeMove(curr_move);
+            rules->PlayMove(curr_move);
             state = BOARD_NORMAL;
         }
     }
@@ -1292,7 +1296,10 @@ void GamePlayerCard::Render()
 
 Game::Game()
 {
+    engine = nullptr;
+    rules = new SwitchChessGame(core->board);
     game_board = new GameBoard;
+    game_board->rules = rules;
     select_promote = new SelectPromote;
     game_select_card = new GameSelectCard;
 
@@ -1324,32 +1331,31 @@ Game::Game()
 
 void Game::Reset(uint8_t _player_color, std::string _op_id, std::string _op_rate, std::string _op_pronoun, uint8_t _op_level)
 {
-    core->board->Reset();
+    rules->Reset(_player_color);
     // core->board->SetPositionFromFENString("8/P7/8/8/8/8/k7/7K w - - 0 1"); // promotion move
     // core->board->SetPositionFromFENString("7k/5ppp/8/6N1/8/8/B4PPP/B4RK1 w - - 0 1"); // mate in 2 moves
-    core->engine->SetLevel(_op_level);
-    core->engine->RunVoidCommand("ucinewgame");
-    core->engine->SetPosition(core->board->GetFENString());
+    core->engine_pool->Release(engine);
+    engine = core->engine_pool->Acquire(_op_level, core->engine_pool->_max_threads);
     
     game_board->Reset();
     select_promote->Reset();
     game_select_card->Reset();
 
     player_color = _player_color;
+    start_color = _player_color;
+    op_id = _op_id;
     game_board->player_color = _player_color;
     select_promote->player_color = _player_color;
 
-    player_have_pass = true;
-    engine_have_pass = true;
-
     state = PLAYING;
 
-    engine_thread_done = false;
-    engine_thread_started = false;
+    engine_move_future = std::future<std::string>();
+    engine_pass_future = std::future<PassDecision>();
+    engine_ponder_future = std::future<std::string>();
     engine_done = false;
     player_done = false;
 
-    remaining_full_moves = 10;
+    remaining_full_moves = rules->_remaining;
 
     plus5_text->Change("five more bonus moves added!", .25f);
     use_pass_text->Change("you have the pass. do you want to use it?", .25f);
@@ -1392,26 +1398,52 @@ void Game::Reset(uint8_t _player_color, std::string _op_id, std::string _op_rate
     text_anim_time = 0;
 }
 
-static void* EngineMakeMove(void *obj)
+SwitchState Game::GetSwitchState()
 {
-    Game *game = (Game*)obj;
-
-    core->engine->SetPosition(core->board->GetFENString());
-    game->engine_move = core->board->GetMoveFromString(core->engine->GetBestMove());
-    game->engine_thread_done = true;
-
-    return nullptr;
+    return rules->GetSwitchState(SWITCH_PLAYER_2);
 }
 
-static void* EngineGetMate(void *obj)
+// COPIES WHAT THE RULES DECIDED INTO THE VIEW STATE
+void Game::SyncRules()
 {
-    Game *game = (Game*)obj;
-
-    core->engine->SetPosition(core->board->GetFENString());
-    game->mate = core->engine->GetMate();
-    game->engine_thread_done = true;
+    player_color = rules->_color[SWITCH_PLAYER_1];
+    game_board->player_color = player_color;
+    select_promote->player_color = player_color;
+    if(remaining_full_moves != rules->_remaining)
+    {
+        remaining_full_moves = rules->_remaining;
+        remaining_moves_text->Change(std::to_string(remaining_full_moves), .25f);
+    }
+}
 
-    return nullptr;
+// APPENDS THE FINISHED GAME TO ARCHIVE_PGN_FILE, CARDS, PASSES AND SWITCHES INCLUDED
+void Game::ArchiveGame()
+{
+    FILE *file = fopen(ARCHIVE_PGN_FILE, "a");
+    if(file == nullptr) return;
+
+    char date[16];
+    time_t now = time(nullptr);
+    strftime(date, sizeof(date), "%Y.%m.%d", localtime(&now));
+
+    PgnGame pgn;
+    pgn.SetTag("Event", "Switch Chess");
+    pgn.SetTag("Site", "?");
+    pgn.SetTag("Date", date);
+    pgn.SetTag("Round", "-");
+    pgn.SetTag("White", (start_color == COLOR_W) ? "you" : op_id);
+    pgn.SetTag("Black", (start_color == COLOR_W) ? op_id : "you");
+
+    uint8_t winner = rules->GetWinner();
+    uint8_t white = (start_color == COLOR_W) ? SWITCH_PLAYER_1 : SWITCH_PLAYER_2;
+    if(winner == SWITCH_DRAW) pgn._result = "1/2-1/2";
+    else pgn._result = (winner == white) ? "1-0" : "0-1";
+    pgn.SetTag("Result", pgn._result);
+    pgn.SetTag("Variant", "Switch Chess");
+    pgn._events = rules->_events;
+
+    WritePgn(file, pgn);
+    fclose(file);
 }
 
 void Game::Process()
@@ -1425,12 +1457,19 @@ void Game::Process()
         game_board->Process();
         if(game_board->state == BOARD_NORMAL)
         {
-            if(core->board->IsGameFinished())
+            SyncRules();
+            if(rules->_phase == SWITCH_FINISHED)
             {
+                if(engine_ponder_future.valid())
+                {
+                    engine->Cancel();
+                    engine_ponder_future = std::future<std::string>();
+                }
+                ArchiveGame();
                 state = GAME_CLOSING;
                 return;
             }
-            else if(remaining_full_moves == 0)
+            else if(rules->_phase == SWITCH_DRAW_CARD)
             {
                 state = SELECT_CARD;
                 game_select_card->Reset();
@@ -1438,16 +1477,16 @@ void Game::Process()
             }
             if(core->board->_current_color == player_color)
             {
+                // THE ENGINE THINKS ON THE PLAYER'S TIME ABOUT THE REPLY IT EXPECTS
+                if(!engine_ponder_future.valid())
+                {
+                    engine_ponder_future = engine->Ponder(*core->board, GetSwitchState());
+                }
                 if(game_board->user_moved)
                 {
                     if(game_board->curr_move._type != PROMOTION)
                     {
                         game_board->user_moved = false;
-                        if(core->board->_current_color == COLOR_B)
-                        {
-                            remaining_full_moves -= 1;
-                            remaining_moves_text->Change(std::to_string(remaining_full_moves), .25f);
-                        }
                         game_board->MakeMove(game_board->curr_move);
                     }
                     else
@@ -1460,24 +1499,28 @@ void Game::Process()
             }
             else
             {
-                if(engine_thread_done)
+                if(IsReady(engine_move_future))
                 {
-                    engine_thread_started = false;
-                    engine_thread_done = false;
-                    if(core->board->_current_color == COLOR_B)
-                    {
-                        remaining_full_moves -= 1;
-                        remaining_moves_text->Change(std::to_string(remaining_full_moves), .25f);
-                    }
+                    engine_move = core->board->GetMoveFromString(engine_move_future.get());
                     game_board->MakeMove(engine_move);
                 }
                 else
                 {
-                    if(!engine_thread_started)
+                    if(!engine_move_future.valid())
                     {
-                        engine_thread_started = true;
-                        pthread_t move_thread;
-                        pthread_create(&move_thread, nullptr, EngineMakeMove, (void*)this);
+                        // A PONDER ON THE MOVE THE PLAYER MADE BECOMES THE SEARCH, ANY OTHER IS DROPPED
+                        if(engine_ponder_future.valid())
+                        {
+                            if(engine->PonderHit(*core->board))
+                            {
+                                engine_move_future = std::move(engine_ponder_future);
+                            }
+                            engine_ponder_future = std::future<std::string>();
+                        }
+                        if(!engine_move_future.valid())
+                        {
+                            engine_move_future = engine->GetBestMove(*core->board, GetSwitchState());
+                        }
                     }
                 }
             }
@@ -1490,11 +1533,6 @@ void Game::Process()
         {
             state = PLAYING;
             game_board->curr_move._inserted = select_promote->piece_sel;
-            if(core->board->_current_color == COLOR_B)
-            {
-                remaining_full_moves -= 1;
-                remaining_moves_text->Change(std::to_string(remaining_full_moves), .25f);
-            }
             game_board->MakeMove(game_board->curr_move);
         }
     }
@@ -1520,47 +1558,26 @@ void Game::Process()
             }
             else
             {
+                if(rules->_phase == SWITCH_DRAW_CARD)
+                {
+                    rules->DrawCard(game_select_card->card_sel_type);
+                }
                 if(game_select_card->card_sel_type == CARD_SWITCH)
                 {
-                    if(engine_have_pass)
+                    if(rules->_has_pass[SWITCH_PLAYER_2])
                     {
                         if(!engine_done)
                         {
-                            if(engine_thread_done)
+                            if(IsReady(engine_pass_future))
                             {
-                                engine_thread_done = false;
-                                engine_thread_started = false;
-                                if(player_color == COLOR_W)
-                                {
-                                    if(mate < 0 && mate >= -10)
-                                    {
-                                        engine_use_card = true;
-                                    }
-                                    else
-                                    {
-                                        engine_use_card = false;
-                                    }
-                                }
-                                else
-                                {
-                                    if(mate > 0 && mate <= 10)
-                                    {
-                                        engine_use_card = true;
-                                    }
-                                    else
-                                    {
-                                        engine_use_card = false;
-                                    }
-                                }
+                                engine_use_card = engine_pass_future.get()._use_pass;
                                 engine_done = true;
                             }
                             else
                             {
-                                if(!engine_thread_started)
+                                if(!engine_pass_future.valid())
                                 {
-                                    engine_thread_started = true;
-                                    pthread_t thread;
-                                    pthread_create(&thread, nullptr, EngineGetMate, (void*)this);
+                                    engine_pass_future = engine->DecidePass(*core->board, GetSwitchState());
                                 }
                             }
                         }
@@ -1571,7 +1588,7 @@ void Game::Process()
                         engine_done = true;
                     }
 
-                    if(player_have_pass)
+                    if(rules->_has_pass[SWITCH_PLAYER_1])
                     {
                         if(!player_done)
                         {
@@ -1641,7 +1658,7 @@ void Game::Process()
                             if(text_anim_time <= 2.25f)
                             {
                                 text_anim_time += core->delta_time;
-                                if(!player_have_pass && !engine_have_pass)
+                                if(!rules->_has_pass[SWITCH_PLAYER_1] && !rules->_has_pass[SWITCH_PLAYER_2])
                                 {
                                     select_card_text1->Process();
                                 }
@@ -1661,39 +1678,30 @@ void Game::Process()
                             }
                             else
                             {
-                                if(player_use_card || engine_use_card)
+                                rules->UsePass(SWITCH_PLAYER_1, player_use_card);
+                                rules->UsePass(SWITCH_PLAYER_2, engine_use_card);
+                                if(player_use_card)
                                 {
-                                    if(player_use_card)
-                                    {
-                                        player1_card->pass->Change("used", .5f);
-                                        player_have_pass = false;
-                                    }
-                                    if(engine_use_card)
-                                    {
-                                        player2_card->pass->Change("used", .5f);
-                                        engine_have_pass = false;
-                                    }
+                                    player1_card->pass->Change("used", .5f);
                                 }
-                                else
+                                if(engine_use_card)
+                                {
+                                    player2_card->pass->Change("used", .5f);
+                                }
+                                if(rules->_color[SWITCH_PLAYER_1] != player_color)
                                 {
-                                    if(player_color == COLOR_W)
+                                    if(rules->_color[SWITCH_PLAYER_1] == COLOR_W)
                                     {
-                                        player_color = COLOR_B;
-                                        player1_card->color->Change("black", .5f);
-                                        player2_card->color->Change("white", .5f);
+                                        player1_card->color->Change("white", .5f);
+                                        player2_card->color->Change("black", .5f);
                                     }
                                     else
                                     {
-                                        player_color = COLOR_W;
-                                        player1_card->color->Change("white", .5f);
-                                        player2_card->color->Change("black", .5f);
+                                        player1_card->color->Change("black", .5f);
+                                        player2_card->color->Change("white", .5f);
                                     }
-                                    game_board->player_color = player_color;
-                                    select_promote->player_color = player_color;
                                 }
-
-                                remaining_full_moves += 10;
-                                remaining_moves_text->Change(std::to_string(remaining_full_moves), .25f);
+                                SyncRules();
 
                                 player_done = false;
                                 engine_done = false;
@@ -1737,8 +1745,7 @@ void Game::Process()
                     }
                     else
                     {
-                        remaining_full_moves += 5;
-                        remaining_moves_text->Change(std::to_string(remaining_full_moves), .25f);
+                        SyncRules();
 
                         state = PLAYING;
                         game_board->Open();
@@ -1816,7 +1823,7 @@ void Game::Render()
         {
             if(game_select_card->card_sel_type == CARD_SWITCH)
             {
-                if(player_have_pass && !player_done)
+                if(rules->_has_pass[SWITCH_PLAYER_1] && !player_done)
                 {
                     use_pass_text->Render(assets->quaver_ttf[1], {core->vp_width*.5f, core->vp_height*.4f}, core->vp_width*.5f, true, true, WHITE);
                     if(pass_btn1_hover)
@@ -1840,7 +1847,7 @@ void Game::Render()
                 {
                     if(engine_done)
                     {
-                        if(!player_have_pass && !engine_have_pass)
+                        if(!rules->_has_pass[SWITCH_PLAYER_1] && !rules->_has_pass[SWITCH_PLAYER_2])
                         {
                             select_card_text1->Render(assets->quaver_ttf[1], {core->vp_width*.5f, core->vp_height*.5f}, core->vp_width*.5f, true, true, WHITE);
                         }
@@ -2131,6 +2138,10 @@ void SceneGame::Process()
                     {
                         finish_text->Change("by 50 move rule", .25f);
                     }
+                    else if(core->board->_game_end_type == THREEFOLD_REPETITION)
+                    {
+                        finish_text->Change("by threefold repetition", .25f);
+                    }
                 }
             }
         }
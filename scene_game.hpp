@@ -6,6 +6,7 @@
 #include <assets.hpp>
 #include <chess.hpp>
 #include <anim_text.hpp>
+#include <switch_chess_game.hpp>
 
 enum BoardState
 {
@@ -50,6 +51,7 @@ struct GameBoard
     float anim_time;
 
     uint8_t player_color;
+    SwitchChessGame *rules;
 
     GameBoard();
     void Reset();
@@ -101,12 +103,6 @@ enum SelectCardState
     SC_DONE
 };
 
-enum CardType
-{
-    CARD_PLUS5,
-    CARD_SWITCH
-};
-
 struct GameSelectCard
 {
     SelectCardState state;
@@ -180,12 +176,15 @@ struct Game
     GameBoard *game_board;
     GameState state;
 
+    SwitchChessGame *rules;    // PLAYER 1 IS THE USER, PLAYER 2 THE ENGINE
     uint8_t player_color;
-    bool player_have_pass;
-    bool engine_have_pass;
+    uint8_t start_color;       // THE USER'S COLOUR BEFORE ANY SWITCH
+    std::string op_id;
 
-    bool engine_thread_started;
-    bool engine_thread_done;
+    EngineWorker *engine;
+    std::future<std::string> engine_move_future;
+    std::future<PassDecision> engine_pass_future;
+    std::future<std::string> engine_ponder_future;
     Move engine_move;
 
     SelectPromote *select_promote;
@@ -217,7 +216,6 @@ struct Game
     bool player_done;
     bool engine_done;
 
-    int mate;
     bool engine_use_card;
     bool player_use_card;
 
@@ -231,6 +229,9 @@ struct Game
 
     Game();
     void Reset(uint8_t _player_color, std::string _op_id, std::string _op_rate, std::string _op_pronoun, uint8_t _op_level);
+    SwitchState GetSwitchState();
+    void SyncRules();
+    void ArchiveGame();
     void Process();
     void Render();
 };
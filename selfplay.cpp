@@ -0,0 +1,97 @@
+#include <match.hpp>
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <thread>
+
+// USAGE
+//   selfplay [--games N] [--threads N] [--level1 L] [--level2 L] [--movetime MS] [--hash MB] [--seed S]
+//            [--max-plies N] [--out FILE] [--pgn FILE]
+//
+// PLAYS SWITCH CHESS GAMES BETWEEN TWO ENGINE PLAYERS, ONE GAME PER THREAD AT A TIME. PLAYER 1 TAKES WHITE
+// IN EVEN NUMBERED GAMES. EVERY GAME IS WRITTEN AS ONE CSV LINE TO --out ("-" FOR STDOUT, THE DEFAULT),
+// PROGRESS AND THE FINAL games/sec AND nodes/sec GO TO STDERR. THE SAME --seed REPLAYS THE SAME CARDS AND
+// ENGINE NOISE. GAMES REPEAT MOVE FOR MOVE ONLY WHEN EVERY SEARCH ENDS ON ITS DEPTH RATHER THAN THE CLOCK:
+// THE PASS DECISION GETS A QUARTER OR LESS OF A MOVE'S TIME, SO GIVE IT ROOM WITH --movetime FOR EXACT REPLAYS.
+// --pgn ALSO WRITES EVERY GAME WITH ITS CARDS, PASSES AND SWITCHES AS IT FINISHES.
+
+int main(int argc, char **argv)
+{
+	MatchConfig config;
+	int threads = std::thread::hardware_concurrency();
+	int level[2] = {config._level[SWITCH_PLAYER_1], config._level[SWITCH_PLAYER_2]};
+	std::string out = "-";
+	std::string pgn_out;
+
+	for(int i = 1; i+1 < argc; i += 2)
+	{
+		if(strcmp(argv[i], "--games") == 0) config._games = atoi(argv[i+1]);
+		else if(strcmp(argv[i], "--threads") == 0) threads = atoi(argv[i+1]);
+		else if(strcmp(argv[i], "--level1") == 0) level[SWITCH_PLAYER_1] = atoi(argv[i+1]);
+		else if(strcmp(argv[i], "--level2") == 0) level[SWITCH_PLAYER_2] = atoi(argv[i+1]);
+		else if(strcmp(argv[i], "--movetime") == 0) config._move_time = atoi(argv[i+1]);
+		else if(strcmp(argv[i], "--hash") == 0) config._hash_mb = atoi(argv[i+1]);
+		else if(strcmp(argv[i], "--seed") == 0) config._seed = strtoull(argv[i+1], nullptr, 10);
+		else if(strcmp(argv[i], "--max-plies") == 0) config._max_plies = atoi(argv[i+1]);
+		else if(strcmp(argv[i], "--out") == 0) out = argv[i+1];
+		else if(strcmp(argv[i], "--pgn") == 0) pgn_out = argv[i+1];
+		else
+		{
+			printf("usage: selfplay [--games N] [--threads N] [--level1 L] [--level2 L] [--movetime MS] [--hash MB] [--seed S]\n");
+			printf("                [--max-plies N] [--out FILE] [--pgn FILE]\n");
+			return 1;
+		}
+	}
+	// CLAMPED BEFORE THEY NARROW TO uint8_t, SO 256 THREADS OR LEVEL 260 DO NOT WRAP AROUND
+	if(threads < 1) threads = 1;
+	if(threads > 255) threads = 255;
+	config._threads = threads;
+	for(uint8_t p = 0; p < 2; p++)
+	{
+		if(level[p] < LEVEL_MIN) level[p] = LEVEL_MIN;
+		if(level[p] > LEVEL_MAX) level[p] = LEVEL_MAX;
+		config._level[p] = level[p];
+	}
+
+	FILE *file = (out == "-") ? stdout : fopen(out.c_str(), "w");
+	if(file == nullptr)
+	{
+		fprintf(stderr, "cannot open %s\n", out.c_str());
+		return 1;
+	}
+	fprintf(file, "%s\n", MATCH_CSV_HEADER);
+
+	FILE *pgn_file = nullptr;
+	if(!pgn_out.empty() && (pgn_file = fopen(pgn_out.c_str(), "w")) == nullptr)
+	{
+		fprintf(stderr, "cannot open %s\n", pgn_out.c_str());
+		return 1;
+	}
+	PgnGame pgn;
+
+	uint32_t done = 0;
+	uint32_t step = (config._games >= 20) ? config._games/20 : 1;
+	MatchStats stats = RunMatch(config, [&](MatchGame &game)
+	{
+		fprintf(file, "%s\n", GetMatchGameCSV(game).c_str());
+		if(pgn_file)
+		{
+			GetMatchGamePgn(game, pgn);
+			WritePgn(pgn_file, pgn);
+		}
+		if(++done % step == 0) fprintf(stderr, "%u/%u games\n", done, config._games);
+		return true;
+	});
+	if(file != stdout) fclose(file);
+	if(pgn_file) fclose(pgn_file);
+
+	fprintf(stderr, "\nPlayer 1 (level %u): %u wins\n", config._level[0], stats._wins[SWITCH_PLAYER_1]);
+	fprintf(stderr, "Player 2 (level %u): %u wins\n", config._level[1], stats._wins[SWITCH_PLAYER_2]);
+	fprintf(stderr, "Draws: %u\n", stats._wins[SWITCH_DRAW]);
+	fprintf(stderr, "Time: %.3fs\n", stats._seconds);
+	fprintf(stderr, "Games/sec: %.2f\n", stats.GamesPerSecond());
+	fprintf(stderr, "Plies/game: %.1f\n", stats._games ? (double)stats._plies/stats._games : 0.0);
+	fprintf(stderr, "Nodes/sec per thread: %.0f\n", stats.NodesPerSecond());
+	return 0;
+}
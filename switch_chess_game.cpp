@@ -0,0 +1,173 @@
+#include <switch_chess_game.hpp>
+
+SwitchChessGame::SwitchChessGame(Board *board)
+{
+	_board = board;
+	Reset(COLOR_W);
+}
+
+void SwitchChessGame::Reset(uint8_t player1_color, uint64_t card_seed)
+{
+	_board->Reset();
+	_phase = SWITCH_PLAYING;
+	_remaining = SWITCH_ROUND_MOVES;
+	_color[SWITCH_PLAYER_1] = player1_color;
+	_color[SWITCH_PLAYER_2] = (player1_color == COLOR_W) ? COLOR_B : COLOR_W;
+	for(uint8_t i = 0; i < 2; i++)
+	{
+		_has_pass[i] = true;
+		_pass_decided[i] = false;
+		_pass_used[i] = false;
+	}
+	_card_seed = card_seed | 1;
+	_events.clear();
+}
+
+uint8_t SwitchChessGame::PlayerToMove()
+{
+	return PlayerOfColor(_board->_current_color);
+}
+
+uint8_t SwitchChessGame::PlayerOfColor(uint8_t color)
+{
+	return (_color[SWITCH_PLAYER_1] == color) ? SWITCH_PLAYER_1 : SWITCH_PLAYER_2;
+}
+
+bool SwitchChessGame::PlayMove(PackedMove move)
+{
+	if(_phase != SWITCH_PLAYING) return false;
+
+	MoveList moves;
+	_board->GetAllLegalMoves(_board->_current_color, moves);
+	bool legal = false;
+	for(uint16_t i = 0; i < moves.Size(); i++)
+	{
+		if(moves[i] == move) legal = true;
+	}
+	if(!legal) return false;
+
+	if(_board->_current_color == COLOR_B && _remaining > 0) _remaining--;
+	_board->MakeMove(move);
+
+	SwitchEvent event;
+	event._type = EVENT_MOVE;
+	event._move = move;
+	_events.push_back(event);
+	UpdatePhase();
+	return true;
+}
+
+bool SwitchChessGame::PlayMove(Move move)
+{
+	return PlayMove(PackMove(move));
+}
+
+// A FINISHED BOARD ENDS THE GAME EVEN WHEN A CARD WAS DUE
+void SwitchChessGame::UpdatePhase()
+{
+	if(_board->IsGameFinished()) _phase = SWITCH_FINISHED;
+	else if(_remaining == 0) _phase = SWITCH_DRAW_CARD;
+	else _phase = SWITCH_PLAYING;
+}
+
+CardType SwitchChessGame::DrawCard()
+{
+	_card_seed ^= _card_seed << 13;
+	_card_seed ^= _card_seed >> 7;
+	_card_seed ^= _card_seed << 17;
+	CardType card = (_card_seed >> 32) & 1 ? CARD_SWITCH : CARD_PLUS5;
+	DrawCard(card);
+	return card;
+}
+
+bool SwitchChessGame::DrawCard(CardType card)
+{
+	if(_phase != SWITCH_DRAW_CARD) return false;
+
+	SwitchEvent event;
+	event._type = EVENT_CARD;
+	event._card = card;
+	_events.push_back(event);
+
+	if(card == CARD_PLUS5)
+	{
+		_remaining += PLUS5_MOVES;
+		UpdatePhase();
+		return true;
+	}
+
+	// PLAYERS WITHOUT A PASS HAVE NOTHING TO DECIDE
+	for(uint8_t i = 0; i < 2; i++)
+	{
+		_pass_decided[i] = !_has_pass[i];
+		_pass_used[i] = false;
+	}
+	_phase = SWITCH_DECIDE_PASS;
+	ResolveSwitch();
+	return true;
+}
+
+bool SwitchChessGame::UsePass(uint8_t player, bool use)
+{
+	if(_phase != SWITCH_DECIDE_PASS || player > SWITCH_PLAYER_2 || _pass_decided[player]) return false;
+
+	_pass_decided[player] = true;
+	_pass_used[player] = use;
+
+	SwitchEvent event;
+	event._type = EVENT_PASS;
+	event._color = _color[player];
+	event._use = use;
+	_events.push_back(event);
+
+	ResolveSwitch();
+	return true;
+}
+
+// ONCE EVERY PASS HOLDER HAS DECIDED: ANY PASS USED CANCELS THE SWITCH AND IS SPENT, OTHERWISE THE PLAYERS
+// TRADE COLOURS. EITHER WAY THE ROUND GETS ITS TEN MOVES
+void SwitchChessGame::ResolveSwitch()
+{
+	if(!_pass_decided[SWITCH_PLAYER_1] || !_pass_decided[SWITCH_PLAYER_2]) return;
+
+	if(_pass_used[SWITCH_PLAYER_1] || _pass_used[SWITCH_PLAYER_2])
+	{
+		for(uint8_t i = 0; i < 2; i++)
+		{
+			if(_pass_used[i]) _has_pass[i] = false;
+		}
+	}
+	else
+	{
+		uint8_t color = _color[SWITCH_PLAYER_1];
+		_color[SWITCH_PLAYER_1] = _color[SWITCH_PLAYER_2];
+		_color[SWITCH_PLAYER_2] = color;
+
+		SwitchEvent event;
+		event._type = EVENT_SWITCH;
+		_events.push_back(event);
+	}
+
+	_remaining += SWITCH_ROUND_MOVES;
+	UpdatePhase();
+}
+
+uint8_t SwitchChessGame::GetWinner()
+{
+	if(_phase != SWITCH_FINISHED || !_board->IsInCheck(_board->_current_color)) return SWITCH_DRAW;
+	MoveList moves;
+	_board->GetAllLegalMoves(_board->_current_color, moves);
+	if(moves.Size() != 0) return SWITCH_DRAW;
+	return (PlayerToMove() == SWITCH_PLAYER_1) ? SWITCH_PLAYER_2 : SWITCH_PLAYER_1;
+}
+
+SwitchState SwitchChessGame::GetSwitchState(uint8_t engine_player)
+{
+	SwitchState state;
+	state._enabled = true;
+	state._remaining = _remaining;
+	state._white_has_pass = _has_pass[PlayerOfColor(COLOR_W)];
+	state._black_has_pass = _has_pass[PlayerOfColor(COLOR_B)];
+	state._engine_color = _color[engine_player];
+	return state;
+}
@@ -0,0 +1,78 @@
+#ifndef SWITCH_CHESS_GAME_HPP
+#define SWITCH_CHESS_GAME_HPP
+
+#include <chess.hpp>
+#include <engine.hpp>
+
+#include <vector>
+#include <cstdint>
+
+// PLAYERS KEEP THEIR INDEX FOR THE WHOLE GAME, ONLY THEIR COLOURS CHANGE
+#define SWITCH_PLAYER_1 0
+#define SWITCH_PLAYER_2 1
+#define SWITCH_DRAW 2
+
+enum CardType
+{
+	CARD_PLUS5,
+	CARD_SWITCH
+};
+
+enum SwitchPhase
+{
+	SWITCH_PLAYING,		// THE SIDE TO MOVE PLAYS
+	SWITCH_DRAW_CARD,	// THE FULL MOVES RAN OUT, A CARD IS DUE
+	SWITCH_DECIDE_PASS,	// A SWITCH WAS DRAWN AND THE PASS HOLDERS ARE DECIDING
+	SWITCH_FINISHED
+};
+
+enum SwitchEventType
+{
+	EVENT_MOVE,
+	EVENT_CARD,
+	EVENT_PASS,		// ONE PASS HOLDER'S DECISION
+	EVENT_SWITCH	// THE PLAYERS TRADED COLOURS
+};
+
+// ONE STEP OF A GAME IN THE ORDER IT HAPPENED, ENOUGH TO REPLAY IT
+struct SwitchEvent
+{
+	SwitchEventType _type = EVENT_MOVE;
+	PackedMove _move = MOVE_NONE;	// EVENT_MOVE
+	CardType _card = CARD_PLUS5;	// EVENT_CARD
+	uint8_t _color = COLOR_W;		// EVENT_PASS: COLOUR THE DECIDING PLAYER HELD AT THE TIME
+	bool _use = false;				// EVENT_PASS
+};
+
+// THE SWITCH CHESS RULES AS A STATE MACHINE WITH NO DRAWING OR TIMING. EVERY ACTION IS CHECKED AGAINST THE
+// PHASE AND RETURNS FALSE WHEN IT DOES NOT APPLY. THE BOARD IS NOT OWNED, SO THE UI CAN HAND IN ITS OWN
+struct SwitchChessGame
+{
+	Board *_board;
+	SwitchPhase _phase;
+	uint8_t _remaining;		// FULL MOVES BEFORE THE NEXT CARD, COUNTED DOWN ON BLACK'S MOVES
+	uint8_t _color[2];		// [PLAYER]
+	bool _has_pass[2];
+	bool _pass_decided[2];	// WHILE SWITCH_DECIDE_PASS
+	bool _pass_used[2];
+	uint64_t _card_seed;
+	std::vector<SwitchEvent> _events;	// SINCE THE LAST Reset
+
+	SwitchChessGame(Board *board);
+	void Reset(uint8_t player1_color, uint64_t card_seed = 1);
+
+	uint8_t PlayerToMove();
+	uint8_t PlayerOfColor(uint8_t color);
+	bool PlayMove(PackedMove move);
+	bool PlayMove(Move move);
+	CardType DrawCard();	// RANDOM CARD FROM _card_seed
+	bool DrawCard(CardType card);
+	bool UsePass(uint8_t player, bool use);
+	uint8_t GetWinner();	// PLAYER INDEX OR SWITCH_DRAW, ONLY MEANINGFUL ONCE FINISHED
+	SwitchState GetSwitchState(uint8_t engine_player);
+
+	void UpdatePhase();
+	void ResolveSwitch();
+};
+
+#endif
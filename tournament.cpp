@@ -0,0 +1,323 @@
+#include <match.hpp>
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// USAGE
+//   tournament [--levels L1,L2,...] [--games N] [--threads N] [--movetime MS] [--hash MB] [--seed S]
+//              [--anchor LEVEL:ELO] [--out FILE]
+//   tournament --sprt ELO0,ELO1 --levels CANDIDATE,BASELINE [--games MAX] [--alpha A] [--beta B] ...
+//
+// ROUND ROBIN: EVERY PAIR OF LEVELS PLAYS --games GAMES ON ALL THREADS, COLOURS ALTERNATING. EACH PAIRING
+// PRINTS ITS SCORE AND ELO DIFFERENCE WITH A 95% INTERVAL, THEN A RATING PER LEVEL IS FITTED OVER ALL
+// GAMES AND SHIFTED SO THE ANCHOR LEVEL (DEFAULT 1:900) SITS AT ITS GIVEN ELO, FOR COMPARISON WITH THE
+// BANDS THE OPPONENT CARDS ADVERTISE.
+// --sprt TESTS H0: CANDIDATE - BASELINE = ELO0 AGAINST H1: = ELO1 AND STOPS AS SOON AS THE LOG LIKELIHOOD
+// RATIO LEAVES [log(beta/(1-alpha)), log((1-beta)/alpha)], OR AFTER --games GAMES WITH NO DECISION.
+// BOTH SIDES ARE CONFIGURATIONS OF THIS BUILD PLAYING EACH OTHER IN PROCESS. IT CANNOT PLAY ANOTHER BUILD:
+// NOTHING HERE DRIVES AN ENGINE IN ANOTHER PROCESS, SO BUILD AGAINST BUILD IS NOT TESTED.
+// --out WRITES EVERY GAME AS A CSV LINE, LIKE selfplay.
+
+#define DEFAULT_ANCHOR_ELO 900
+
+struct Pairing
+{
+	uint8_t _level[2];
+	uint32_t _wins = 0;		// FOR _level[0]
+	uint32_t _draws = 0;
+	uint32_t _losses = 0;
+};
+
+// EXPECTED SCORE OF A PLAYER elo POINTS STRONGER, AND ITS INVERSE
+static double EloToScore(double elo)
+{
+	return 1.0 / (1.0 + pow(10.0, -elo/400.0));
+}
+
+static double ScoreToElo(double score)
+{
+	if(score <= 0.0) score = 1e-6;
+	if(score >= 1.0) score = 1.0-1e-6;
+	return -400.0*log10(1.0/score - 1.0);
+}
+
+// MEAN AND PER GAME VARIANCE OF THE SCORE, COUNTING A DRAW AS HALF A POINT
+static void ScoreStats(uint32_t wins, uint32_t draws, uint32_t losses, double &mean, double &variance)
+{
+	double games = wins + draws + losses;
+	mean = (wins + 0.5*draws) / games;
+	variance = (wins*(1.0-mean)*(1.0-mean) + draws*(0.5-mean)*(0.5-mean) + losses*mean*mean) / games;
+}
+
+// ELO DIFFERENCE WITH THE HALF WIDTH OF ITS 95% CONFIDENCE INTERVAL
+static void EloInterval(uint32_t wins, uint32_t draws, uint32_t losses, double &elo, double &error)
+{
+	double mean, variance;
+	ScoreStats(wins, draws, losses, mean, variance);
+	double deviation = sqrt(variance / (wins + draws + losses));
+	elo = ScoreToElo(mean);
+	error = (ScoreToElo(mean + 1.96*deviation) - ScoreToElo(mean - 1.96*deviation)) / 2.0;
+}
+
+// GENERALISED SPRT WITH THE NORMAL APPROXIMATION OF THE SCORE
+static double SprtLLR(uint32_t wins, uint32_t draws, uint32_t losses, double elo0, double elo1)
+{
+	uint32_t games = wins + draws + losses;
+	if(games == 0) return 0.0;
+
+	double mean, variance;
+	ScoreStats(wins, draws, losses, mean, variance);
+	if(variance <= 0.0) return 0.0;
+
+	double score0 = EloToScore(elo0);
+	double score1 = EloToScore(elo1);
+	return games * (score1-score0) * (2.0*mean - score0 - score1) / (2.0*variance);
+}
+
+// BRADLEY-TERRY FIT BY MINORISATION-MAXIMISATION, A DRAW IS HALF A WIN FOR EACH SIDE. RETURNS ELO
+// RELATIVE TO THE MEAN
+static std::vector<double> FitRatings(std::vector<uint8_t> &levels, std::vector<Pairing> &pairings)
+{
+	size_t n = levels.size();
+	std::vector<double> points(n, 0.0);
+	std::vector<double> played(n, 0.0);
+	for(Pairing &pairing : pairings)
+	{
+		for(size_t i = 0; i < n; i++)
+		{
+			uint32_t games = pairing._wins + pairing._draws + pairing._losses;
+			if(levels[i] == pairing._level[0])
+			{
+				points[i] += pairing._wins + 0.5*pairing._draws;
+				played[i] += games;
+			}
+			if(levels[i] == pairing._level[1])
+			{
+				points[i] += pairing._losses + 0.5*pairing._draws;
+				played[i] += games;
+			}
+		}
+	}
+	// A CLEAN SWEEP EITHER WAY HAS NO FINITE RATING, KEEP EVERY LEVEL HALF A POINT AWAY FROM IT
+	for(size_t i = 0; i < n; i++)
+	{
+		if(points[i] < 0.5) points[i] = 0.5;
+		if(points[i] > played[i]-0.5) points[i] = played[i]-0.5;
+	}
+
+	std::vector<double> gamma(n, 1.0);
+	for(uint32_t iteration = 0; iteration < 1000; iteration++)
+	{
+		std::vector<double> next(n, 0.0);
+		for(size_t i = 0; i < n; i++)
+		{
+			double sum = 0.0;
+			for(Pairing &pairing : pairings)
+			{
+				double games = pairing._wins + pairing._draws + pairing._losses;
+				size_t a = 0, b = 0;
+				for(size_t k = 0; k < n; k++)
+				{
+					if(levels[k] == pairing._level[0]) a = k;
+					if(levels[k] == pairing._level[1]) b = k;
+				}
+				if(a == i || b == i) sum += games / (gamma[a] + gamma[b]);
+			}
+			next[i] = (sum > 0) ? points[i]/sum : gamma[i];
+		}
+		double log_mean = 0.0;
+		for(size_t i = 0; i < n; i++)
+		{
+			log_mean += log(next[i]) / n;
+		}
+		for(size_t i = 0; i < n; i++)
+		{
+			gamma[i] = next[i] / exp(log_mean);
+		}
+	}
+
+	std::vector<double> elo(n);
+	for(size_t i = 0; i < n; i++)
+	{
+		elo[i] = 400.0*log10(gamma[i]);
+	}
+	return elo;
+}
+
+static void ParseList(const char *text, std::vector<double> &values)
+{
+	std::stringstream list(text);
+	std::string entry;
+	while(std::getline(list, entry, ','))
+	{
+		values.push_back(atof(entry.c_str()));
+	}
+}
+
+int main(int argc, char **argv)
+{
+	MatchConfig config;
+	int threads = std::thread::hardware_concurrency();
+	config._games = 20;
+	std::vector<uint8_t> levels;
+	uint8_t anchor_level = LEVEL_MIN;
+	double anchor_elo = DEFAULT_ANCHOR_ELO;
+	bool sprt = false;
+	double elo0 = 0, elo1 = 0, alpha = 0.05, beta = 0.05;
+	std::string out;
+	bool usage = false;
+
+	for(int i = 1; i+1 < argc; i += 2)
+	{
+		if(strcmp(argv[i], "--levels") == 0)
+		{
+			std::vector<double> values;
+			ParseList(argv[i+1], values);
+			for(double value : values)
+			{
+				if(value >= LEVEL_MIN && value <= LEVEL_MAX) levels.push_back((uint8_t)value);
+			}
+		}
+		else if(strcmp(argv[i], "--sprt") == 0)
+		{
+			std::vector<double> values;
+			ParseList(argv[i+1], values);
+			sprt = true;
+			if(values.size() == 2)
+			{
+				elo0 = values[0];
+				elo1 = values[1];
+			}
+			else usage = true;
+		}
+		else if(strcmp(argv[i], "--anchor") == 0)
+		{
+			anchor_level = atoi(argv[i+1]);
+			const char *colon = strchr(argv[i+1], ':');
+			if(colon) anchor_elo = atof(colon+1);
+		}
+		else if(strcmp(argv[i], "--games") == 0) config._games = atoi(argv[i+1]);
+		else if(strcmp(argv[i], "--threads") == 0) threads = atoi(argv[i+1]);
+		else if(strcmp(argv[i], "--movetime") == 0) config._move_time = atoi(argv[i+1]);
+		else if(strcmp(argv[i], "--hash") == 0) config._hash_mb = atoi(argv[i+1]);
+		else if(strcmp(argv[i], "--seed") == 0) config._seed = strtoull(argv[i+1], nullptr, 10);
+		else if(strcmp(argv[i], "--alpha") == 0) alpha = atof(argv[i+1]);
+		else if(strcmp(argv[i], "--beta") == 0) beta = atof(argv[i+1]);
+		else if(strcmp(argv[i], "--out") == 0) out = argv[i+1];
+		else usage = true;
+	}
+	if(argc % 2 == 0) usage = true;
+	if(levels.empty() && !sprt)
+	{
+		for(uint8_t level = LEVEL_MIN; level <= LEVEL_MAX; level++)
+		{
+			levels.push_back(level);
+		}
+	}
+	if(usage || levels.size() < 2 || (sprt && levels.size() != 2) || config._games < 1)
+	{
+		printf("usage: tournament [--levels L1,L2,...] [--games N] [--threads N] [--movetime MS] [--hash MB] [--seed S]\n");
+		printf("                  [--anchor LEVEL:ELO] [--out FILE]\n");
+		printf("       tournament --sprt ELO0,ELO1 --levels CANDIDATE,BASELINE [--games MAX] [--alpha A] [--beta B] ...\n");
+		printf("       (CANDIDATE and BASELINE are levels of this build played head to head; another build cannot be played)\n");
+		return 1;
+	}
+	// CLAMPED BEFORE IT NARROWS TO uint8_t, SO 256 THREADS DO NOT WRAP AROUND
+	if(threads < 1) threads = 1;
+	if(threads > 255) threads = 255;
+	config._threads = threads;
+
+	FILE *file = nullptr;
+	if(!out.empty())
+	{
+		file = (out == "-") ? stdout : fopen(out.c_str(), "w");
+		if(file == nullptr)
+		{
+			fprintf(stderr, "cannot open %s\n", out.c_str());
+			return 1;
+		}
+		fprintf(file, "%s\n", MATCH_CSV_HEADER);
+	}
+
+	std::vector<Pairing> pairings;
+	for(size_t a = 0; a < levels.size(); a++)
+	{
+		for(size_t b = a+1; b < levels.size(); b++)
+		{
+			Pairing pairing;
+			pairing._level[0] = levels[a];
+			pairing._level[1] = levels[b];
+			pairings.push_back(pairing);
+		}
+	}
+
+	double lower = log(beta / (1.0-alpha));
+	double upper = log((1.0-beta) / alpha);
+	double seconds = 0;
+	uint32_t games = 0;
+	uint64_t seed = config._seed;
+
+	for(uint32_t p = 0; p < pairings.size(); p++)
+	{
+		Pairing &pairing = pairings[p];
+		config._level[SWITCH_PLAYER_1] = pairing._level[0];
+		config._level[SWITCH_PLAYER_2] = pairing._level[1];
+		// EVERY PAIRING DRAWS FROM ITS OWN CARD SEQUENCES
+		config._seed = CardSeed(seed, p);
+
+		MatchStats stats = RunMatch(config, [&](MatchGame &game)
+		{
+			if(game._winner == SWITCH_PLAYER_1) pairing._wins++;
+			else if(game._winner == SWITCH_PLAYER_2) pairing._losses++;
+			else pairing._draws++;
+
+			if(file) fprintf(file, "%s\n", GetMatchGameCSV(game).c_str());
+			if(!sprt) return true;
+
+			double llr = SprtLLR(pairing._wins, pairing._draws, pairing._losses, elo0, elo1);
+			return llr > lower && llr < upper;
+		});
+		seconds += stats._seconds;
+		games += stats._games;
+
+		double elo, error;
+		EloInterval(pairing._wins, pairing._draws, pairing._losses, elo, error);
+		printf("level %u vs level %u: +%u =%u -%u  elo %+.0f +/- %.0f  (%.2f games/s, %.0f nps)\n", pairing._level[0], pairing._level[1],
+			pairing._wins, pairing._draws, pairing._losses, elo, error, stats.GamesPerSecond(), stats.NodesPerSecond());
+		fflush(stdout);
+
+		if(sprt)
+		{
+			double llr = SprtLLR(pairing._wins, pairing._draws, pairing._losses, elo0, elo1);
+			const char *verdict = (llr >= upper) ? "H1 accepted" : (llr <= lower ? "H0 accepted" : "no decision");
+			printf("SPRT elo0 %.1f elo1 %.1f: LLR %.2f [%.2f, %.2f] %s after %u games\n", elo0, elo1, llr, lower, upper, verdict, stats._games);
+		}
+	}
+	if(file && file != stdout) fclose(file);
+
+	if(!sprt)
+	{
+		std::vector<double> ratings = FitRatings(levels, pairings);
+		double shift = anchor_elo;
+		for(size_t i = 0; i < levels.size(); i++)
+		{
+			if(levels[i] == anchor_level) shift = anchor_elo - ratings[i];
+		}
+		printf("\nlevel  rating\n");
+		for(size_t i = 0; i < levels.size(); i++)
+		{
+			printf("%5u  %6.0f\n", levels[i], ratings[i] + shift);
+		}
+	}
+
+	printf("\nGames: %u\n", games);
+	printf("Time: %.3fs\n", seconds);
+	printf("Games/sec: %.2f\n", seconds > 0 ? games/seconds : 0.0);
+	return 0;
+}
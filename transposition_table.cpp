@@ -0,0 +1,142 @@
+#include <transposition_table.hpp>
+
+// DATA LAYOUT: BITS 0-15 MOVE, 16-31 SCORE, 32-39 DEPTH, 40-41 BOUND, 42-47 GENERATION
+static uint64_t PackData(PackedMove move, int16_t score, uint8_t depth, uint8_t bound, uint8_t generation)
+{
+	return (uint64_t)move | ((uint64_t)(uint16_t)score << 16) | ((uint64_t)depth << 32) | ((uint64_t)bound << 40) | ((uint64_t)(generation & 63) << 42);
+}
+
+static TTData UnpackData(uint64_t data)
+{
+	TTData unpacked;
+	unpacked._move = data & 0xFFFF;
+	unpacked._score = (int16_t)((data >> 16) & 0xFFFF);
+	unpacked._depth = (data >> 32) & 0xFF;
+	unpacked._bound = (data >> 40) & 3;
+	unpacked._generation = (data >> 42) & 63;
+	return unpacked;
+}
+
+TranspositionTable::TranspositionTable(uint32_t mb)
+{
+	_buckets = nullptr;
+	_bucket_count = 0;
+	_size_mb = 0;
+	_generation = 0;
+	Resize(mb);
+}
+
+TranspositionTable::~TranspositionTable()
+{
+	delete[] _buckets;
+}
+
+void TranspositionTable::Resize(uint32_t mb)
+{
+	if(mb < 1) mb = 1;
+
+	delete[] _buckets;
+	_size_mb = mb;
+	_bucket_count = ((uint64_t)mb << 20) / sizeof(TTBucket);
+	_buckets = new TTBucket[_bucket_count];
+	Clear();
+}
+
+void TranspositionTable::Clear()
+{
+	for(uint64_t i = 0; i < _bucket_count; i++)
+	{
+		for(uint8_t j = 0; j < TT_BUCKET_SIZE; j++)
+		{
+			_buckets[i]._entries[j]._check.store(0, std::memory_order_relaxed);
+			_buckets[i]._entries[j]._data.store(0, std::memory_order_relaxed);
+		}
+	}
+	_generation = 0;
+}
+
+void TranspositionTable::NewSearch()
+{
+	_generation = (_generation + 1) & 63;
+}
+
+// MAPS THE KEY ONTO THE BUCKET RANGE WITH A MULTIPLY, SO THE SIZE NEED NOT BE A POWER OF TWO
+static inline uint64_t BucketIndex(uint64_t key, uint64_t count)
+{
+	return ((unsigned __int128)key * count) >> 64;
+}
+
+bool TranspositionTable::Probe(uint64_t key, TTData &data)
+{
+	TTBucket &bucket = _buckets[BucketIndex(key, _bucket_count)];
+	for(uint8_t i = 0; i < TT_BUCKET_SIZE; i++)
+	{
+		uint64_t stored = bucket._entries[i]._data.load(std::memory_order_relaxed);
+		uint64_t check = bucket._entries[i]._check.load(std::memory_order_relaxed);
+		if(stored != 0 && (check ^ stored) == key)
+		{
+			data = UnpackData(stored);
+			return true;
+		}
+	}
+	return false;
+}
+
+void TranspositionTable::Store(uint64_t key, PackedMove move, int32_t score, uint8_t depth, uint8_t bound)
+{
+	TTBucket &bucket = _buckets[BucketIndex(key, _bucket_count)];
+
+	// THE SAME POSITION IS OVERWRITTEN IN PLACE, OTHERWISE THE SHALLOWEST AND OLDEST ENTRY MAKES ROOM
+	TTEntry *victim = &bucket._entries[0];
+	int32_t victim_worth = 1 << 30;
+	for(uint8_t i = 0; i < TT_BUCKET_SIZE; i++)
+	{
+		TTEntry &entry = bucket._entries[i];
+		uint64_t stored = entry._data.load(std::memory_order_relaxed);
+		uint64_t check = entry._check.load(std::memory_order_relaxed);
+
+		if(stored == 0)
+		{
+			victim = &entry;
+			break;
+		}
+		if((check ^ stored) == key)
+		{
+			TTData old = UnpackData(stored);
+			// A SHALLOWER RESULT FROM THIS SEARCH DOES NOT REPLACE A DEEPER ONE, EXCEPT AN EXACT SCORE
+			if(bound != BOUND_EXACT && old._generation == _generation && depth+2 < old._depth) return;
+			if(move == MOVE_NONE) move = old._move;
+			victim = &entry;
+			break;
+		}
+
+		TTData old = UnpackData(stored);
+		int32_t age = (_generation - old._generation) & 63;
+		int32_t worth = old._depth - 8*age;
+		if(worth < victim_worth)
+		{
+			victim = &entry;
+			victim_worth = worth;
+		}
+	}
+
+	uint64_t data = PackData(move, (int16_t)score, depth, bound, _generation);
+	victim->_data.store(data, std::memory_order_relaxed);
+	victim->_check.store(key ^ data, std::memory_order_relaxed);
+}
+
+uint16_t TranspositionTable::HashFull()
+{
+	uint64_t sample = (_bucket_count < 250) ? _bucket_count : 250;
+	uint32_t used = 0;
+	for(uint64_t i = 0; i < sample; i++)
+	{
+		for(uint8_t j = 0; j < TT_BUCKET_SIZE; j++)
+		{
+			uint64_t stored = _buckets[i]._entries[j]._data.load(std::memory_order_relaxed);
+			if(stored != 0 && UnpackData(stored)._generation == _generation) used++;
+		}
+	}
+	if(sample == 0) return 0;
+	return used*1000 / (sample*TT_BUCKET_SIZE);
+}
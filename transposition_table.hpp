@@ -0,0 +1,61 @@
+#ifndef TRANSPOSITION_TABLE_HPP
+#define TRANSPOSITION_TABLE_HPP
+
+#include <chess.hpp>
+
+#include <atomic>
+#include <cstdint>
+
+// BOUND TYPE OF A STORED SCORE
+#define BOUND_NONE 0
+#define BOUND_UPPER 1	// FAILED LOW, THE REAL SCORE IS AT MOST THIS
+#define BOUND_LOWER 2	// FAILED HIGH, THE REAL SCORE IS AT LEAST THIS
+#define BOUND_EXACT 3
+
+#define TT_BUCKET_SIZE 4
+#define TT_DEFAULT_MB 16
+
+struct TTData
+{
+	PackedMove _move = MOVE_NONE;
+	int16_t _score = 0;
+	uint8_t _depth = 0;
+	uint8_t _bound = BOUND_NONE;
+	uint8_t _generation = 0;
+};
+
+// AN ENTRY IS TWO WORDS: THE PACKED DATA AND THE POSITION KEY XORED WITH IT. A READER THAT CATCHES
+// ANOTHER THREAD HALFWAY THROUGH A WRITE SEES A KEY THAT NO LONGER MATCHES AND TREATS IT AS A MISS
+struct TTEntry
+{
+	std::atomic<uint64_t> _check;
+	std::atomic<uint64_t> _data;
+};
+
+// ONE BUCKET FILLS ONE CACHE LINE, SO A PROBE TOUCHES A SINGLE LINE
+struct alignas(64) TTBucket
+{
+	TTEntry _entries[TT_BUCKET_SIZE];
+};
+
+// SHARED BY EVERY SEARCH THREAD, NO LOCKS
+struct TranspositionTable
+{
+	TTBucket *_buckets;
+	uint64_t _bucket_count;
+	uint32_t _size_mb;
+	uint8_t _generation;	// 6 BITS, BUMPED ONCE PER SEARCH SO OLD ENTRIES ARE REPLACED FIRST
+
+	TranspositionTable(uint32_t mb = TT_DEFAULT_MB);
+	~TranspositionTable();
+
+	void Resize(uint32_t mb);
+	void Clear();
+	void NewSearch();
+
+	bool Probe(uint64_t key, TTData &data);
+	void Store(uint64_t key, PackedMove move, int32_t score, uint8_t depth, uint8_t bound);
+	uint16_t HashFull();	// PERMILLE OF SAMPLED ENTRIES WRITTEN BY THE CURRENT SEARCH
+};
+
+#endif